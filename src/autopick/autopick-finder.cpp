@@ -8,6 +8,7 @@
 #include "autopick/autopick-finder.h"
 #include "autopick/autopick-dirty-flags.h"
 #include "autopick/autopick-entry.h"
+#include "autopick/autopick-match-cache.h"
 #include "autopick/autopick-matcher.h"
 #include "autopick/autopick-util.h"
 #include "core/show-file.h"
@@ -32,6 +33,7 @@
  * @details
  * A function for Auto-picker/destroyer
  * Examine whether the object matches to the list of keywords or not.
+ * アイテム自身の状態による判定は AutopickMatchCache に保存されたものを使う.
  */
 int find_autopick_list(PlayerType *player_ptr, ItemEntity *o_ptr)
 {
@@ -39,11 +41,8 @@ int find_autopick_list(PlayerType *player_ptr, ItemEntity *o_ptr)
         return -1;
     }
 
-    auto item_name = describe_flavor(player_ptr, o_ptr, (OD_NO_FLAVOR | OD_OMIT_PREFIX | OD_NO_PLURAL));
-    str_tolower(item_name.data());
-    for (auto i = 0U; i < autopick_list.size(); i++) {
-        const auto &entry = autopick_list[i];
-        if (is_autopick_match(player_ptr, o_ptr, entry, item_name)) {
+    for (const auto i : AutopickMatchCache::get_instance().get_item_matches(player_ptr, o_ptr)) {
+        if (is_autopick_player_match(player_ptr, o_ptr, autopick_list[i])) {
             return i;
         }
     }
@@ -0,0 +1,167 @@
+/*!
+ * @brief 自動拾いの判定結果キャッシュ
+ * @details
+ * 拾う際の判定、サブウィンドウや全体マップの表示などで同じアイテムが何度も自動拾いリストと照合される.
+ * アイテム名の生成とリスト全体の照合はアイテムの状態が変わらない限り同じ結果になるため、
+ * 床上のアイテムと所持品のスロットごとに結果を保存して使い回す.
+ */
+
+#include "autopick/autopick-match-cache.h"
+#include "autopick/autopick-matcher.h"
+#include "autopick/autopick-util.h"
+#include "core/show-file.h"
+#include "flavor/flavor-describer.h"
+#include "flavor/object-flavor-types.h"
+#include "game-option/text-display-options.h"
+#include "object/tval-types.h"
+#include "system/floor-type-definition.h"
+#include "system/player-type-definition.h"
+#include "world/world.h"
+
+/*!
+ * @brief アイテム名の生成にプレイヤーの状態が関わるかを調べる
+ * @details 武器のダイス (騎乗時のランス、クエスト対象)、弓の射撃速度、矢弾や鉄製の楔の期待ダメージが該当する.
+ */
+static bool is_player_dependent_name(const ItemEntity &item)
+{
+    switch (item.bi_key.tval()) {
+    case ItemKindType::SHOT:
+    case ItemKindType::BOLT:
+    case ItemKindType::ARROW:
+    case ItemKindType::HAFTED:
+    case ItemKindType::POLEARM:
+    case ItemKindType::SWORD:
+    case ItemKindType::DIGGING:
+    case ItemKindType::BOW:
+    case ItemKindType::SPIKE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+autopick_match_key::autopick_match_key(const ItemEntity &item)
+    : bi_id(item.bi_id)
+    , aware(item.is_aware())
+    , tried(item.is_tried())
+    , ident(item.ident)
+    , feeling(item.feeling)
+    , pval(item.pval)
+    , number(item.number)
+    , to_h(item.to_h)
+    , to_d(item.to_d)
+    , to_a(item.to_a)
+    , ac(item.ac)
+    , dd(item.dd)
+    , ds(item.ds)
+    , timeout(item.timeout)
+    , fuel(item.fuel)
+    , discount(item.discount)
+    , fixed_artifact_idx(item.fixed_artifact_idx)
+    , ego_idx(item.ego_idx)
+    , activation_id(item.activation_id)
+    , smith_hit(item.smith_hit)
+    , smith_damage(item.smith_damage)
+    , smith_effect(item.smith_effect)
+    , smith_act_idx(item.smith_act_idx)
+    , art_flags(item.art_flags)
+    , curse_flags(item.curse_flags)
+    , inscription(item.inscription)
+    , randart_name(item.randart_name)
+    , abbrev_extra(::abbrev_extra)
+    , abbrev_all(::abbrev_all)
+    , player_dependent_turn(is_player_dependent_name(item) ? w_ptr->game_turn : 0)
+{
+}
+
+AutopickMatchCache AutopickMatchCache::instance{};
+
+AutopickMatchCache &AutopickMatchCache::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief アイテム自身の状態で一致しうる自動拾いエントリの番号一覧を返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param o_ptr アイテムへの参照ポインタ
+ * @return 昇順に並んだエントリ番号の一覧
+ * @details 床上か所持品のアイテムで、状態が前回の判定から変わっていなければ再計算しない.
+ * 返した参照は次にこのキャッシュを使うまで有効.
+ */
+const std::vector<int> &AutopickMatchCache::get_item_matches(PlayerType *player_ptr, ItemEntity *o_ptr)
+{
+    auto &entry = this->get_entry(player_ptr, o_ptr);
+    autopick_match_key key(*o_ptr);
+    if ((entry.epoch == this->epoch) && (entry.key == key)) {
+        return entry.matches;
+    }
+
+    this->collect_matches(player_ptr, o_ptr, entry.matches);
+    entry.key = std::move(key);
+    entry.epoch = (&entry == &this->scratch_entry) ? 0 : this->epoch;
+    return entry.matches;
+}
+
+/*!
+ * @brief 自動拾いリストの世代を返す
+ * @details 自動拾いの判定結果を別途保持している処理が、作り直しの要否を判定するために使う.
+ */
+uint32_t AutopickMatchCache::get_epoch() const
+{
+    return this->epoch;
+}
+
+/*!
+ * @brief 全てのキャッシュを無効にする
+ * @details 自動拾いリストを読み込み直した時や、エントリを追加した時に呼ぶ.
+ */
+void AutopickMatchCache::invalidate()
+{
+    this->epoch++;
+    if (this->epoch == 0) {
+        this->epoch = 1;
+        for (auto &entry : this->inventory_entries) {
+            entry.epoch = 0;
+        }
+
+        for (auto &entry : this->floor_entries) {
+            entry.epoch = 0;
+        }
+    }
+}
+
+/*!
+ * @brief アイテムの置き場所に対応するキャッシュを得る
+ * @details 店の商品や一時的なコピーなど、床上にも所持品にもないアイテムは保存しない.
+ */
+AutopickMatchCache::entry_type &AutopickMatchCache::get_entry(PlayerType *player_ptr, const ItemEntity *o_ptr)
+{
+    const auto *inventory = player_ptr->inventory_list.get();
+    if ((inventory != nullptr) && (o_ptr >= inventory) && (o_ptr < inventory + INVEN_TOTAL)) {
+        return this->inventory_entries[o_ptr - inventory];
+    }
+
+    const auto &o_list = player_ptr->current_floor_ptr->o_list;
+    if (o_list.empty() || (o_ptr < o_list.data()) || (o_ptr >= o_list.data() + o_list.size())) {
+        return this->scratch_entry;
+    }
+
+    if (this->floor_entries.size() < o_list.size()) {
+        this->floor_entries.resize(o_list.size());
+    }
+
+    return this->floor_entries[o_ptr - o_list.data()];
+}
+
+void AutopickMatchCache::collect_matches(PlayerType *player_ptr, ItemEntity *o_ptr, std::vector<int> &matches) const
+{
+    matches.clear();
+    auto item_name = describe_flavor(player_ptr, o_ptr, (OD_NO_FLAVOR | OD_OMIT_PREFIX | OD_NO_PLURAL));
+    str_tolower(item_name.data());
+    for (auto i = 0U; i < autopick_list.size(); i++) {
+        if (is_autopick_item_match(player_ptr, o_ptr, autopick_list[i], item_name)) {
+            matches.push_back(i);
+        }
+    }
+}
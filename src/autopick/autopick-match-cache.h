@@ -0,0 +1,94 @@
+#pragma once
+
+#include "inventory/inventory-slot-types.h"
+#include "system/item-entity.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+class PlayerType;
+
+/*!
+ * @brief 自動拾いの判定に影響するアイテム側の状態
+ * @details 識別・認識・呪いの知識や刻み、修正値など、アイテム名と is_autopick_item_match() の結果を左右する値を保持する.
+ * 名前がプレイヤーの状態 (射撃速度や騎乗など) に依存する武器・弓・矢弾類は、同じゲームターンの間に限り一致とみなす.
+ */
+struct autopick_match_key {
+    short bi_id{};
+    bool aware = false;
+    bool tried = false;
+    byte ident{};
+    byte feeling{};
+    PARAMETER_VALUE pval{};
+    ITEM_NUMBER number{};
+    HIT_PROB to_h{};
+    int to_d{};
+    ARMOUR_CLASS to_a{};
+    ARMOUR_CLASS ac{};
+    DICE_NUMBER dd{};
+    DICE_SID ds{};
+    TIME_EFFECT timeout{};
+    short fuel{};
+    byte discount{};
+    FixedArtifactId fixed_artifact_idx{};
+    EgoType ego_idx{};
+    RandomArtActType activation_id{};
+    byte smith_hit{};
+    byte smith_damage{};
+    std::optional<SmithEffectType> smith_effect{};
+    std::optional<RandomArtActType> smith_act_idx{};
+    TrFlags art_flags{};
+    EnumClassFlagGroup<CurseTraitType> curse_flags{};
+    std::optional<std::string> inscription{};
+    std::optional<std::string> randart_name{};
+    bool abbrev_extra = false;
+    bool abbrev_all = false;
+    GAME_TURN player_dependent_turn{};
+
+    autopick_match_key() = default;
+    autopick_match_key(const ItemEntity &item);
+    bool operator==(const autopick_match_key &other) const = default;
+};
+
+/*!
+ * @brief 床上と所持品のアイテムごとに自動拾いの判定結果を保持するキャッシュ
+ * @details
+ * アイテム自身の状態だけで決まる判定 (アイテム名の生成を含む) の結果として、一致しうるエントリ番号の一覧を保持する.
+ * 賞金首や収集中など、プレイヤーやフロアの状態に依存する条件は呼び出し側が毎回判定する.
+ * 自動拾いリストが変更された時は invalidate() で世代を進め、全てのキャッシュを無効にする.
+ */
+class AutopickMatchCache {
+public:
+    AutopickMatchCache(const AutopickMatchCache &) = delete;
+    AutopickMatchCache(AutopickMatchCache &&) = delete;
+    AutopickMatchCache &operator=(const AutopickMatchCache &) = delete;
+    AutopickMatchCache &operator=(AutopickMatchCache &&) = delete;
+    ~AutopickMatchCache() = default;
+
+    static AutopickMatchCache &get_instance();
+
+    const std::vector<int> &get_item_matches(PlayerType *player_ptr, ItemEntity *o_ptr);
+    uint32_t get_epoch() const;
+    void invalidate();
+
+private:
+    AutopickMatchCache() = default;
+
+    struct entry_type {
+        uint32_t epoch = 0; /*!< 0は未計算を表す */
+        autopick_match_key key{};
+        std::vector<int> matches{};
+    };
+
+    static AutopickMatchCache instance;
+
+    uint32_t epoch = 1;
+    std::array<entry_type, INVEN_TOTAL> inventory_entries{};
+    std::vector<entry_type> floor_entries{};
+    entry_type scratch_entry{};
+
+    entry_type &get_entry(PlayerType *player_ptr, const ItemEntity *o_ptr);
+    void collect_matches(PlayerType *player_ptr, ItemEntity *o_ptr, std::vector<int> &matches) const;
+};
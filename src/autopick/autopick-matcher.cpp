@@ -128,9 +128,11 @@ static bool check_item_features(PlayerType *player_ptr, const autopick_type &ent
 }
 
 /*!
- * @brief A function for Auto-picker/destroyer Examine whether the object matches to the entry
+ * @brief アイテム自身の状態だけで決まる条件がエントリに一致するかを調べる
+ * @details プレイヤーやフロアの状態に依存する条件は is_autopick_player_match() で判定する.
+ * 結果はアイテムの状態が変わらない限り不変なので、自動拾いの判定キャッシュに保存できる.
  */
-bool is_autopick_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick_type &entry, std::string_view item_name)
+bool is_autopick_item_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick_type &entry, std::string_view item_name)
 {
     if (entry.has(FLG_UNAWARE) && o_ptr->is_aware()) {
         return false;
@@ -157,10 +159,6 @@ bool is_autopick_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick
         if ((o_ptr->dd == baseitem.dd) && (o_ptr->ds == baseitem.ds)) {
             return false;
         }
-
-        if (!o_ptr->is_known() && object_is_quest_target(player_ptr->current_floor_ptr->quest_number, o_ptr)) {
-            return false;
-        }
     }
 
     if (entry.has(FLG_MORE_DICE)) {
@@ -290,10 +288,6 @@ bool is_autopick_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick
         return false;
     }
 
-    if (entry.has(FLG_WANTED) && !object_is_bounty(player_ptr, o_ptr)) {
-        return false;
-    }
-
     // @details このタイミングでは、svalは絶対にnulloptにならない、はず.
     const auto &bi_key = o_ptr->bi_key;
     const auto tval = bi_key.tval();
@@ -307,21 +301,6 @@ bool is_autopick_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick
         return false;
     }
 
-    if (entry.has(FLG_UNREADABLE) && check_book_realm(player_ptr, bi_key)) {
-        return false;
-    }
-
-    PlayerClass pc(player_ptr);
-    auto realm_except_class = pc.equals(PlayerClassType::SORCERER) || pc.equals(PlayerClassType::RED_MAGE);
-
-    if (entry.has(FLG_REALM1) && ((get_realm1_book(player_ptr) != tval) || realm_except_class)) {
-        return false;
-    }
-
-    if (entry.has(FLG_REALM2) && ((get_realm2_book(player_ptr) != tval) || realm_except_class)) {
-        return false;
-    }
-
     if (entry.has(FLG_FIRST) && (!o_ptr->is_spell_book() || (sval != 0))) {
         return false;
     }
@@ -347,11 +326,44 @@ bool is_autopick_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick
             return false;
         }
     } else {
-        if (!str_find(std::string(item_name), entry.name)) {
+        if (!str_find(item_name, entry.name)) {
             return false;
         }
     }
 
+    return true;
+}
+
+/*!
+ * @brief プレイヤーやフロアの状態に依存する条件がエントリに一致するかを調べる
+ * @details 賞金首、魔法領域、収集中の判定など、アイテムの状態が変わらなくても結果が変わりうる条件だけを扱う.
+ */
+bool is_autopick_player_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick_type &entry)
+{
+    if (entry.has(FLG_BOOSTED) && !o_ptr->is_known() && object_is_quest_target(player_ptr->current_floor_ptr->quest_number, o_ptr)) {
+        return false;
+    }
+
+    if (entry.has(FLG_WANTED) && !object_is_bounty(player_ptr, o_ptr)) {
+        return false;
+    }
+
+    const auto &bi_key = o_ptr->bi_key;
+    if (entry.has(FLG_UNREADABLE) && check_book_realm(player_ptr, bi_key)) {
+        return false;
+    }
+
+    PlayerClass pc(player_ptr);
+    auto realm_except_class = pc.equals(PlayerClassType::SORCERER) || pc.equals(PlayerClassType::RED_MAGE);
+    const auto tval = bi_key.tval();
+    if (entry.has(FLG_REALM1) && ((get_realm1_book(player_ptr) != tval) || realm_except_class)) {
+        return false;
+    }
+
+    if (entry.has(FLG_REALM2) && ((get_realm2_book(player_ptr) != tval) || realm_except_class)) {
+        return false;
+    }
+
     if (!entry.has(FLG_COLLECTING)) {
         return true;
     }
@@ -369,3 +381,11 @@ bool is_autopick_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick
 
     return false;
 }
+
+/*!
+ * @brief A function for Auto-picker/destroyer Examine whether the object matches to the entry
+ */
+bool is_autopick_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick_type &entry, std::string_view item_name)
+{
+    return is_autopick_item_match(player_ptr, o_ptr, entry, item_name) && is_autopick_player_match(player_ptr, o_ptr, entry);
+}
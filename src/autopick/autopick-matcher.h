@@ -6,4 +6,6 @@
 struct autopick_type;
 class ItemEntity;
 class PlayerType;
+bool is_autopick_item_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick_type &entry, std::string_view item_name);
+bool is_autopick_player_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick_type &entry);
 bool is_autopick_match(PlayerType *player_ptr, ItemEntity *o_ptr, const autopick_type &entry, std::string_view item_name);
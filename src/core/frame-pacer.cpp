@@ -0,0 +1,53 @@
+/*!
+ * @brief 連続行動中の画面描画の間引き
+ */
+
+#include "core/frame-pacer.h"
+#include "core/player-processor.h"
+#include "core/window-redrawer.h"
+#include "game-option/runtime-arguments.h"
+
+FramePacer FramePacer::instance{};
+
+FramePacer &FramePacer::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief 今画面を描画すべきかを返す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return 描画すべきならtrue. trueを返した時刻を次の判定の起点とする
+ */
+bool FramePacer::is_frame_due(PlayerType *player_ptr)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if ((arg_frame_budget_msec > 0) && continuous_action_running(player_ptr) && (now - this->last_frame_time < std::chrono::milliseconds(arg_frame_budget_msec))) {
+        this->has_deferred_frame = true;
+        return false;
+    }
+
+    this->last_frame_time = now;
+    this->has_deferred_frame = false;
+    return true;
+}
+
+/*!
+ * @brief 見送った描画が残っていれば今すぐ行う
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return 描画を行ったか
+ * @details 入力待ちの直前に呼び、プロンプトと一緒に古い画面が表示されたままにならないようにする.
+ * 状態の再計算は見送っていないため、描画だけを行う.
+ */
+bool FramePacer::draw_deferred_frame(PlayerType *player_ptr)
+{
+    if (!this->has_deferred_frame) {
+        return false;
+    }
+
+    this->last_frame_time = std::chrono::steady_clock::now();
+    this->has_deferred_frame = false;
+    redraw_stuff(player_ptr);
+    window_stuff(player_ptr);
+    return true;
+}
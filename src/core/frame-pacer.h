@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+
+class PlayerType;
+
+/*!
+ * @brief 連続行動中の画面描画の間隔を調整する
+ * @details
+ * 休憩・走行・繰り返しコマンドなどの連続行動中は、ゲームターンごとに画面を描き直しても途中の様子は人の目に見えない.
+ * 前回の描画から arg_frame_budget_msec ミリ秒が経つまでは描画を見送り、状態の再計算だけを行う.
+ * 連続行動が妨害などで終わった時は次の更新からすぐ描画し、見送った描画が残ったまま入力を待つ時はその場で描画する.
+ */
+class FramePacer {
+public:
+    FramePacer(const FramePacer &) = delete;
+    FramePacer(FramePacer &&) = delete;
+    FramePacer &operator=(const FramePacer &) = delete;
+    FramePacer &operator=(FramePacer &&) = delete;
+    ~FramePacer() = default;
+
+    static FramePacer &get_instance();
+
+    bool is_frame_due(PlayerType *player_ptr);
+    bool draw_deferred_frame(PlayerType *player_ptr);
+
+private:
+    FramePacer() = default;
+
+    static FramePacer instance;
+
+    std::chrono::steady_clock::time_point last_frame_time{}; //!< 最後に描画した時刻
+    bool has_deferred_frame = false; //!< 描画を見送ったままか
+};
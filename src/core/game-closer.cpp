@@ -15,6 +15,7 @@
 #include "game-option/cheat-options.h"
 #include "io/files-util.h"
 #include "io/input-key-acceptor.h"
+#include "io/record-play-movie.h"
 #include "io/signal-handlers.h"
 #include "io/uid-checker.h"
 #include "io/write-diary.h"
@@ -156,6 +157,7 @@ void close_game(PlayerType *player_ptr)
     safe_setuid_drop();
 
     if (!check_death(player_ptr)) {
+        finish_movie_recording();
         return;
     }
 
@@ -191,4 +193,5 @@ void close_game(PlayerType *player_ptr)
     }
 
     clear_floor(player_ptr);
+    finish_movie_recording();
 }
@@ -118,4 +118,6 @@ void compact_objects(PlayerType *player_ptr, int size)
         compact_objects_aux(floor_ptr, floor_ptr->o_max - 1, i);
         floor_ptr->o_max--;
     }
+
+    floor_ptr->o_free_list.clear();
 }
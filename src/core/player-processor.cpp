@@ -266,10 +266,11 @@ void process_player(PlayerType *player_ptr)
         player_ptr->now_damaged = false;
 
         update_monsters(player_ptr, false);
-        handle_stuff(player_ptr);
-        move_cursor_relative(player_ptr->y, player_ptr->x);
-        if (fresh_before) {
-            term_fresh_force();
+        if (handle_stuff_paced(player_ptr)) {
+            move_cursor_relative(player_ptr->y, player_ptr->x);
+            if (fresh_before) {
+                term_fresh_force();
+            }
         }
 
         pack_overflow(player_ptr);
@@ -307,7 +308,7 @@ void process_player(PlayerType *player_ptr)
         } else if (command_rep) {
             command_rep--;
             rfu.set_flag(MainWindowRedrawingFlag::ACTION);
-            handle_stuff(player_ptr);
+            handle_stuff_paced(player_ptr);
             msg_flag = false;
             prt("", 0, 0);
             process_command(player_ptr);
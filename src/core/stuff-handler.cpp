@@ -1,4 +1,5 @@
 #include "core/stuff-handler.h"
+#include "core/frame-pacer.h"
 #include "core/window-redrawer.h"
 #include "player/player-status.h"
 #include "system/player-type-definition.h"
@@ -23,6 +24,26 @@ void handle_stuff(PlayerType *player_ptr)
     }
 }
 
+/*!
+ * @brief 連続行動中は描画の間隔を空けながら全更新処理を行う
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return 画面を描画したか
+ * @details 描画を見送る時も状態の再計算は必ず行う. 見送った描画のフラグは残り、次に描画する時にまとめて反映される.
+ */
+bool handle_stuff_paced(PlayerType *player_ptr)
+{
+    if (FramePacer::get_instance().is_frame_due(player_ptr)) {
+        handle_stuff(player_ptr);
+        return true;
+    }
+
+    if (RedrawingFlagsUpdater::get_instance().any_stats()) {
+        update_creature(player_ptr);
+    }
+
+    return false;
+}
+
 /*
  * Track the given monster race
  */
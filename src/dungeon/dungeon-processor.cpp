@@ -4,10 +4,12 @@
 #include "core/disturbance.h"
 #include "core/object-compressor.h"
 #include "core/player-processor.h"
+#include "core/speed-table.h"
 #include "core/stuff-handler.h"
 #include "core/turn-compensator.h"
 #include "core/window-redrawer.h"
 #include "dungeon/quest.h"
+#include "floor/floor-events.h"
 #include "floor/floor-leaver.h"
 #include "floor/floor-save-util.h"
 #include "floor/floor-save.h"
@@ -43,6 +45,7 @@
 #include "view/display-messages.h"
 #include "world/world-turn-processor.h"
 #include "world/world.h"
+#include <algorithm>
 
 static void redraw_character_xtra(PlayerType *player_ptr)
 {
@@ -84,6 +87,94 @@ static void redraw_character_xtra(PlayerType *player_ptr)
     w_ptr->character_xtra = false;
 }
 
+/*!
+ * @brief ゲームターンを1つ進める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ */
+static void advance_game_turn(PlayerType *player_ptr)
+{
+    w_ptr->game_turn++;
+    if (w_ptr->dungeon_turn < w_ptr->dungeon_turn_limit) {
+        if (!player_ptr->wild_mode || wild_regen) {
+            w_ptr->dungeon_turn++;
+        } else if (player_ptr->wild_mode && !(w_ptr->game_turn % ((MAX_HGT + MAX_WID) / 2))) {
+            w_ptr->dungeon_turn++;
+        }
+    }
+}
+
+/*!
+ * @brief 誰も行動せず世界の処理も起こらないゲームターンをまとめて経過させる
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @details
+ * 休憩や繰り返しコマンドの最中も、メインループは1ゲームターンごとにプレイヤー・モンスター・世界の処理と再描画を行う.
+ * 次にプレイヤーかモンスターの行動値が溜まり切るか、10ゲームターン毎の世界の処理か、雰囲気の更新が起こるまでの間は
+ * 行動値の蓄積とターン数の加算しか起こらないため、その分をまとめて反映する.
+ * 乱数を使う処理は一切飛ばさないので、1ターンずつ進めた場合と結果は変わらない.
+ * 行動できるかどうかの判定に全モンスターの走査が要るため、休憩や繰り返しコマンドなどの連続行動中だけ行う.
+ */
+static void skip_idle_game_turns(PlayerType *player_ptr)
+{
+    if (!continuous_action_running(player_ptr)) {
+        return;
+    }
+
+    if (load || player_ptr->hack_mutation || player_ptr->invoking_midnight_curse || AngbandSystem::get_instance().is_phase_out()) {
+        return;
+    }
+
+    const auto turn_in_tick = w_ptr->game_turn % TURNS_PER_TICK;
+    if (turn_in_tick == 0) {
+        return;
+    }
+
+    int max_turns = TURNS_PER_TICK - turn_in_tick;
+    max_turns = std::min(max_turns, w_ptr->game_turn_limit - w_ptr->game_turn - 1);
+    const auto feeling_turn = get_next_dungeon_feeling_turn(player_ptr);
+    if (feeling_turn) {
+        max_turns = std::min(max_turns, *feeling_turn - w_ptr->game_turn);
+    }
+
+    const int energy = speed_to_energy(player_ptr->pspeed);
+    max_turns = std::min(max_turns, (player_ptr->energy_need - 1) / energy);
+    max_turns = std::min(max_turns, (player_ptr->enchant_energy_need - 1) / energy);
+    if (max_turns <= 0) {
+        return;
+    }
+
+    const auto turns = skip_idle_monster_turns(player_ptr, max_turns);
+    if (turns <= 0) {
+        return;
+    }
+
+    player_ptr->energy_need -= static_cast<ENERGY>(energy * turns);
+    player_ptr->enchant_energy_need -= static_cast<ENERGY>(energy * turns);
+    player_ptr->current_floor_ptr->monster_noise = false;
+    for (auto i = 0; i < turns; i++) {
+        advance_game_turn(player_ptr);
+        if (wild_regen) {
+            wild_regen--;
+        }
+    }
+}
+
+/*!
+ * @brief ゲームターン中の各処理の後に更新処理と画面の描画を行う
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @details 連続行動中は FramePacer によって描画が間引かれる.
+ */
+static void handle_stuff_in_turn(PlayerType *player_ptr)
+{
+    if (!handle_stuff_paced(player_ptr)) {
+        return;
+    }
+
+    move_cursor_relative(player_ptr->y, player_ptr->x);
+    if (fresh_after) {
+        term_fresh_force();
+    }
+}
+
 /*!
  * process_player()、process_world() をcore.c から移設するのが先.
  * process_upkeep_with_speed() はこの関数と同じところでOK
@@ -213,68 +304,38 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
     mproc_init(&floor);
 
     while (true) {
+        // 空きの添字は m_pop() / o_pop() が再利用するため、詰め直しは上限に迫った時だけ行う
         if ((floor.m_cnt + 32 > w_ptr->max_m_idx) && !is_watching) {
             compact_monsters(player_ptr, 64);
         }
 
-        if ((floor.m_cnt + 32 < floor.m_max) && !is_watching) {
-            compact_monsters(player_ptr, 0);
-        }
-
         if (floor.o_cnt + 32 > w_ptr->max_o_idx) {
             compact_objects(player_ptr, 64);
         }
 
-        if (floor.o_cnt + 32 < floor.o_max) {
-            compact_objects(player_ptr, 0);
-        }
-
         process_player(player_ptr);
         process_upkeep_with_speed(player_ptr);
-        handle_stuff(player_ptr);
-
-        move_cursor_relative(player_ptr->y, player_ptr->x);
-        if (fresh_after) {
-            term_fresh_force();
-        }
+        handle_stuff_in_turn(player_ptr);
 
         if (!player_ptr->playing || player_ptr->is_dead) {
             break;
         }
 
         process_monsters(player_ptr);
-        handle_stuff(player_ptr);
-
-        move_cursor_relative(player_ptr->y, player_ptr->x);
-        if (fresh_after) {
-            term_fresh_force();
-        }
+        handle_stuff_in_turn(player_ptr);
 
         if (!player_ptr->playing || player_ptr->is_dead) {
             break;
         }
 
         WorldTurnProcessor(player_ptr).process_world();
-        handle_stuff(player_ptr);
-
-        move_cursor_relative(player_ptr->y, player_ptr->x);
-        if (fresh_after) {
-            term_fresh_force();
-        }
+        handle_stuff_in_turn(player_ptr);
 
         if (!player_ptr->playing || player_ptr->is_dead) {
             break;
         }
 
-        w_ptr->game_turn++;
-        if (w_ptr->dungeon_turn < w_ptr->dungeon_turn_limit) {
-            if (!player_ptr->wild_mode || wild_regen) {
-                w_ptr->dungeon_turn++;
-            } else if (player_ptr->wild_mode && !(w_ptr->game_turn % ((MAX_HGT + MAX_WID) / 2))) {
-                w_ptr->dungeon_turn++;
-            }
-        }
-
+        advance_game_turn(player_ptr);
         prevent_turn_overflow(player_ptr);
 
         if (player_ptr->leaving) {
@@ -284,6 +345,8 @@ void process_dungeon(PlayerType *player_ptr, bool load_game)
         if (wild_regen) {
             wild_regen--;
         }
+
+        skip_idle_game_turns(player_ptr);
     }
 
     if ((inside_quest(quest_num)) && questor_ptr->kind_flags.has_not(MonsterKindType::UNIQUE)) {
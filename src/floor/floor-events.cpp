@@ -276,6 +276,37 @@ static byte get_dungeon_feeling(PlayerType *player_ptr)
     return 10;
 }
 
+/*!
+ * @brief 雰囲気を更新するまでの待ちゲームターン数を求める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param floor 現在フロアへの参照
+ * @return 待ちゲームターン数
+ */
+static int calc_dungeon_feeling_delay(PlayerType *player_ptr, const FloorType &floor)
+{
+    return std::max(10, 150 - player_ptr->skill_fos) * (150 - floor.dun_level) * TURNS_PER_TICK / 100;
+}
+
+/*!
+ * @brief 雰囲気を感じ取れない固定クエストのフロアか判定する
+ * @param floor 現在フロアへの参照
+ * @return 雰囲気を感じ取れないならtrue
+ */
+static bool is_feeling_quest(const FloorType &floor)
+{
+    auto quest_num = floor.get_quest_id();
+    const auto &quest_list = QuestList::get_instance();
+
+    auto dungeon_quest = (quest_num == QuestId::OBERON);
+    dungeon_quest |= (quest_num == QuestId::SERPENT);
+    dungeon_quest |= !(quest_list[quest_num].flags & QUEST_FLAG_PRESET);
+
+    auto feeling_quest = inside_quest(quest_num);
+    feeling_quest &= QuestType::is_fixed(quest_num);
+    feeling_quest &= !dungeon_quest;
+    return feeling_quest;
+}
+
 /*!
  * @brief ダンジョンの雰囲気を更新し、変化があった場合メッセージを表示する
  * / Update dungeon feeling, and announce it if changed
@@ -291,24 +322,15 @@ void update_dungeon_feeling(PlayerType *player_ptr)
         return;
     }
 
-    int delay = std::max(10, 150 - player_ptr->skill_fos) * (150 - floor.dun_level) * TURNS_PER_TICK / 100;
+    int delay = calc_dungeon_feeling_delay(player_ptr, floor);
     if (w_ptr->game_turn < player_ptr->feeling_turn + delay && !cheat_xtra) {
         return;
     }
 
-    auto quest_num = floor.get_quest_id();
-    const auto &quest_list = QuestList::get_instance();
-
-    auto dungeon_quest = (quest_num == QuestId::OBERON);
-    dungeon_quest |= (quest_num == QuestId::SERPENT);
-    dungeon_quest |= !(quest_list[quest_num].flags & QUEST_FLAG_PRESET);
-
-    auto feeling_quest = inside_quest(quest_num);
-    feeling_quest &= QuestType::is_fixed(quest_num);
-    feeling_quest &= !dungeon_quest;
-    if (feeling_quest) {
+    if (is_feeling_quest(floor)) {
         return;
     }
+
     byte new_feeling = get_dungeon_feeling(player_ptr);
     player_ptr->feeling_turn = w_ptr->game_turn;
     if (player_ptr->feeling == new_feeling) {
@@ -324,6 +346,30 @@ void update_dungeon_feeling(PlayerType *player_ptr)
     }
 }
 
+/*!
+ * @brief update_dungeon_feeling() が雰囲気の更新を行う最初のゲームターンを求める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return ゲームターン. このフロアで更新が起こらないならstd::nullopt
+ * @details これより前のゲームターンの update_dungeon_feeling() は何もしない.
+ */
+std::optional<GAME_TURN> get_next_dungeon_feeling_turn(PlayerType *player_ptr)
+{
+    const auto &floor = *player_ptr->current_floor_ptr;
+    if (!floor.dun_level || AngbandSystem::get_instance().is_phase_out()) {
+        return std::nullopt;
+    }
+
+    if (cheat_xtra) {
+        return w_ptr->game_turn;
+    }
+
+    if (is_feeling_quest(floor)) {
+        return std::nullopt;
+    }
+
+    return player_ptr->feeling_turn + calc_dungeon_feeling_delay(player_ptr, floor);
+}
+
 /*
  * Glow deep lava and building entrances in the floor
  */
@@ -398,4 +444,5 @@ void forget_view(FloorType *floor_ptr)
     }
 
     floor_ptr->view_n = 0;
+    floor_ptr->view_version++;
 }
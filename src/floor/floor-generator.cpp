@@ -17,6 +17,7 @@
 #include "floor/floor-generator.h"
 #include "floor/floor-save.h" //!< @todo precalc_cur_num_of_pet() が依存している、違和感.
 #include "floor/floor-util.h"
+#include "floor/line-of-sight-cache.h"
 #include "floor/wild.h"
 #include "game-option/birth-options.h"
 #include "game-option/cheat-types.h"
@@ -33,6 +34,7 @@
 #include "monster-floor/place-monster-types.h"
 #include "monster-race/monster-race.h"
 #include "monster/monster-flag-types.h"
+#include "monster/monster-spatial-index.h"
 #include "monster/monster-status-setter.h"
 #include "monster/monster-status.h"
 #include "monster/monster-update.h"
@@ -365,6 +367,7 @@ void clear_cave(PlayerType *player_ptr)
     std::fill_n(floor_ptr->o_list.begin(), floor_ptr->o_max, ItemEntity{});
     floor_ptr->o_max = 1;
     floor_ptr->o_cnt = 0;
+    floor_ptr->o_free_list.clear();
 
     for (auto &[r_idx, r_ref] : monraces_info) {
         r_ref.cur_num = 0;
@@ -373,6 +376,7 @@ void clear_cave(PlayerType *player_ptr)
     std::fill_n(floor_ptr->m_list.begin(), floor_ptr->m_max, MonsterEntity{});
     floor_ptr->m_max = 1;
     floor_ptr->m_cnt = 0;
+    floor_ptr->m_free_list.clear();
     for (int i = 0; i < MAX_MTIMED; i++) {
         floor_ptr->mproc_max[i] = 0;
     }
@@ -396,6 +400,8 @@ void clear_cave(PlayerType *player_ptr)
     floor_ptr->base_level = floor_ptr->dun_level;
     floor_ptr->monster_level = floor_ptr->base_level;
     floor_ptr->object_level = floor_ptr->base_level;
+    LineOfSightCache::get_instance().invalidate();
+    MonsterSpatialIndex::get_instance().invalidate();
 }
 
 typedef bool (*IsWallFunc)(const FloorType *, int, int);
@@ -19,6 +19,7 @@
 #include "monster-race/monster-race.h"
 #include "monster/monster-describer.h"
 #include "monster/monster-description-types.h"
+#include "monster/monster-spatial-index.h"
 #include "pet/pet-util.h"
 #include "save/floor-writer.h"
 #include "spell-class/spells-mirror-master.h"
@@ -242,6 +243,7 @@ static void get_out_monster(PlayerType *player_ptr)
         floor_ptr->grid_array[ny][nx].m_idx = m_idx;
         m_ptr->fy = ny;
         m_ptr->fx = nx;
+        MonsterSpatialIndex::get_instance().update(*floor_ptr, m_idx);
         return;
     }
 }
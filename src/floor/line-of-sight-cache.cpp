@@ -0,0 +1,207 @@
+/*!
+ * @brief 視線と投射可否の判定キャッシュ
+ * @details
+ * ペットの攻撃対象選び、モンスターの魔法の照準、召喚、ボールの爆風範囲などで los() と projectable() は
+ * 同じフロアに対して何度も呼ばれる. 経路の計算を相対位置ごとの雛形に、地形の参照をビット列の検査に置き換えて高速化する.
+ * 投射の雛形は projection_path と共有する.
+ */
+
+#include "floor/line-of-sight-cache.h"
+#include "floor/cave.h"
+#include "floor/line-of-sight.h"
+#include "grid/feature-flag-types.h"
+#include "system/floor-type-definition.h"
+#include "system/grid-type-definition.h"
+#include "system/terrain-type-definition.h"
+#include "target/projection-path-calculator.h"
+#include "world/world.h"
+#include <cstdlib>
+
+LineOfSightCache LineOfSightCache::instance{};
+
+LineOfSightCache &LineOfSightCache::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief キャッシュを用いてLOSを判定する
+ * @param floor 判定するフロアへの参照
+ * @param pos1 始点
+ * @param pos2 終点
+ * @return LOSが通っているか. キャッシュで判定できない場合はstd::nullopt
+ */
+std::optional<bool> LineOfSightCache::los(const FloorType &floor, const Pos2D &pos1, const Pos2D &pos2)
+{
+    if (!this->prepare(floor, pos1, pos2)) {
+        return std::nullopt;
+    }
+
+    const auto &ray = this->los_templates[template_index(pos2.y - pos1.y, pos2.x - pos1.x)];
+    const auto origin_index = pos1.y * this->width + pos1.x;
+    for (auto i = ray.start; i < ray.start + ray.count; i++) {
+        const auto &offset = this->offsets[i];
+        if (!test_bit(this->los_bits, origin_index + offset.y * this->width + offset.x)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * @brief キャッシュを用いて投射可否を判定する
+ * @param floor 判定するフロアへの参照
+ * @param pos1 始点
+ * @param pos2 終点
+ * @param range 射程
+ * @return ボルトが終点まで届くか. キャッシュで判定できない場合はstd::nullopt
+ * @details 終点の手前までの全てのマスが射程内で、投射を通しフロアの内側にある時に限り届く.
+ * 経路は projection_path と同じ雛形を辿る.
+ */
+std::optional<bool> LineOfSightCache::projectable(const FloorType &floor, const Pos2D &pos1, const Pos2D &pos2, int range)
+{
+    if ((range > PROJECTION_TEMPLATE_RANGE) || !this->prepare(floor, pos1, pos2)) {
+        return std::nullopt;
+    }
+
+    const Pos2D offset(pos2.y - pos1.y, pos2.x - pos1.x);
+    const auto origin_index = pos1.y * this->width + pos1.x;
+    for (const auto &step : get_projection_path_template(offset.y, offset.x)) {
+        if ((step.y == offset.y) && (step.x == offset.x)) {
+            return true;
+        }
+
+        const auto index = origin_index + step.y * this->width + step.x;
+        if ((step.distance >= range) || !test_bit(this->projection_bits, index)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * @brief 地形が変化したマスをビット列に反映する
+ * @param floor 地形が変化したフロアへの参照
+ * @param pos 地形が変化したマス
+ */
+void LineOfSightCache::update_grid(const FloorType &floor, const Pos2D &pos)
+{
+    this->terrain_version++;
+    if (!this->is_valid || (this->floor_ptr != &floor)) {
+        return;
+    }
+
+    if ((pos.y < 0) || (pos.x < 0) || (pos.y >= this->height) || (pos.x >= this->width)) {
+        return;
+    }
+
+    this->set_bits(floor, pos.y, pos.x);
+}
+
+/*!
+ * @brief ビット列を破棄する
+ * @details フロアの生成・読み込みを始める時に呼ぶ. 次の判定時に作り直す.
+ */
+void LineOfSightCache::invalidate()
+{
+    this->terrain_version++;
+    this->is_valid = false;
+}
+
+/*!
+ * @brief 地形の変化を受け取った回数を返す
+ * @details 地形に依存する結果を別途保持している処理が、作り直しの要否を判定するために使う.
+ */
+uint32_t LineOfSightCache::get_terrain_version() const
+{
+    return this->terrain_version;
+}
+
+/*!
+ * @brief キャッシュを使える状況か調べ、必要なら雛形とビット列を用意する
+ */
+bool LineOfSightCache::prepare(const FloorType &floor, const Pos2D &pos1, const Pos2D &pos2)
+{
+    if (!w_ptr->character_dungeon) {
+        return false;
+    }
+
+    const auto is_inside = [&floor](const Pos2D &pos) {
+        return (pos.y >= 0) && (pos.x >= 0) && (pos.y < floor.height) && (pos.x < floor.width);
+    };
+    if (!is_inside(pos1) || !is_inside(pos2)) {
+        return false;
+    }
+
+    if ((std::abs(pos2.y - pos1.y) > TEMPLATE_RANGE) || (std::abs(pos2.x - pos1.x) > TEMPLATE_RANGE)) {
+        return false;
+    }
+
+    if (this->los_templates.empty()) {
+        this->build_los_templates();
+    }
+
+    if (!this->is_valid || (this->floor_ptr != &floor) || (this->height != floor.height) || (this->width != floor.width)) {
+        this->build_bits(floor);
+    }
+
+    return true;
+}
+
+void LineOfSightCache::build_los_templates()
+{
+    constexpr auto size = TEMPLATE_RANGE * 2 + 1;
+    this->los_templates.resize(size * size);
+    for (auto dy = -TEMPLATE_RANGE; dy <= TEMPLATE_RANGE; dy++) {
+        for (auto dx = -TEMPLATE_RANGE; dx <= TEMPLATE_RANGE; dx++) {
+            auto &ray = this->los_templates[template_index(dy, dx)];
+            ray.start = static_cast<uint32_t>(this->offsets.size());
+            for (const auto &grid : get_los_grids(dy, dx)) {
+                this->offsets.push_back({ static_cast<int8_t>(grid.y), static_cast<int8_t>(grid.x) });
+            }
+
+            ray.count = static_cast<uint16_t>(this->offsets.size() - ray.start);
+        }
+    }
+}
+
+void LineOfSightCache::build_bits(const FloorType &floor)
+{
+    this->floor_ptr = &floor;
+    this->height = floor.height;
+    this->width = floor.width;
+    const auto words = (this->height * this->width + 63) / 64;
+    this->los_bits.assign(words, 0);
+    this->projection_bits.assign(words, 0);
+    for (auto y = 0; y < this->height; y++) {
+        for (auto x = 0; x < this->width; x++) {
+            this->set_bits(floor, y, x);
+        }
+    }
+
+    this->is_valid = true;
+}
+
+void LineOfSightCache::set_bits(const FloorType &floor, int y, int x)
+{
+    const auto &terrain = floor.grid_array[y][x].get_terrain();
+    const auto is_inner = (y > 0) && (x > 0) && (y < this->height - 1) && (x < this->width - 1);
+    const auto index = y * this->width + x;
+    const auto mask = uint64_t(1) << (index & 63);
+    auto &los_word = this->los_bits[index >> 6];
+    auto &projection_word = this->projection_bits[index >> 6];
+    los_word = terrain.flags.has(TerrainCharacteristics::LOS) ? (los_word | mask) : (los_word & ~mask);
+    projection_word = (is_inner && terrain.flags.has(TerrainCharacteristics::PROJECT)) ? (projection_word | mask) : (projection_word & ~mask);
+}
+
+bool LineOfSightCache::test_bit(const std::vector<uint64_t> &bits, int index)
+{
+    return ((bits[index >> 6] >> (index & 63)) & 1) != 0;
+}
+
+int LineOfSightCache::template_index(int dy, int dx)
+{
+    return (dy + TEMPLATE_RANGE) * (TEMPLATE_RANGE * 2 + 1) + (dx + TEMPLATE_RANGE);
+}
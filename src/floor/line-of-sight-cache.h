@@ -0,0 +1,72 @@
+#pragma once
+
+#include "util/point-2d.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class FloorType;
+
+/*!
+ * @brief 視線と投射可否の判定を高速化するキャッシュ
+ * @details
+ * los() と projectable() が調べるマスは始点と終点の相対位置だけで決まるため、相対位置ごとの経路 (レイの雛形) を事前に計算しておく.
+ * 投射の雛形は projection_path と共有する.
+ * 現在のフロアの各マスについて「光を通すか」「投射を通すか」をビット列として保持し、判定を雛形の各マスのビット検査に置き換える.
+ * ビット列はフロアの生成・読み込み時に破棄し、ゲーム中の地形変化はマス単位で反映する.
+ * フロアの生成中 (character_dungeon が偽の間) は地形が直接書き換えられるため使用しない.
+ */
+class LineOfSightCache {
+public:
+    LineOfSightCache(const LineOfSightCache &) = delete;
+    LineOfSightCache(LineOfSightCache &&) = delete;
+    LineOfSightCache &operator=(const LineOfSightCache &) = delete;
+    LineOfSightCache &operator=(LineOfSightCache &&) = delete;
+    ~LineOfSightCache() = default;
+
+    static constexpr int TEMPLATE_RANGE = 36; //!< 雛形を用意する相対距離の上限 (闘技場の射程に合わせる)
+
+    static LineOfSightCache &get_instance();
+
+    std::optional<bool> los(const FloorType &floor, const Pos2D &pos1, const Pos2D &pos2);
+    std::optional<bool> projectable(const FloorType &floor, const Pos2D &pos1, const Pos2D &pos2, int range);
+    void update_grid(const FloorType &floor, const Pos2D &pos);
+    void invalidate();
+    uint32_t get_terrain_version() const;
+
+private:
+    LineOfSightCache() = default;
+
+    /*!
+     * @brief 相対位置1つ分の視線の雛形
+     */
+    struct ray_template {
+        uint32_t start = 0; //!< 雛形のマス一覧の先頭位置
+        uint16_t count = 0; //!< 調べるマスの数
+    };
+
+    struct ray_offset {
+        int8_t y;
+        int8_t x;
+    };
+
+    static LineOfSightCache instance;
+
+    std::vector<ray_template> los_templates{};
+    std::vector<ray_offset> offsets{};
+
+    const FloorType *floor_ptr = nullptr;
+    int height = 0;
+    int width = 0;
+    bool is_valid = false;
+    uint32_t terrain_version = 0; //!< 地形の変化を受け取った回数
+    std::vector<uint64_t> los_bits{};
+    std::vector<uint64_t> projection_bits{};
+
+    bool prepare(const FloorType &floor, const Pos2D &pos1, const Pos2D &pos2);
+    void build_los_templates();
+    void build_bits(const FloorType &floor);
+    void set_bits(const FloorType &floor, int y, int x);
+    static bool test_bit(const std::vector<uint64_t> &bits, int index);
+    static int template_index(int dy, int dx);
+};
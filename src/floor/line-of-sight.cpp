@@ -1,52 +1,17 @@
 #include "floor/line-of-sight.h"
 #include "floor/cave.h"
+#include "floor/line-of-sight-cache.h"
 #include "system/floor-type-definition.h"
 #include "system/player-type-definition.h"
 
 /*!
- * @brief LOS(Line Of Sight / 視線が通っているか)の判定を行う。
- * @param player_ptr プレイヤーへの参照ポインタ
- * @param y1 始点のy座標
- * @param x1 始点のx座標
- * @param y2 終点のy座標
- * @param x2 終点のx座標
+ * @brief 視線の判定で調べるマスを順に辿る
+ * @param is_open マスが光を通すかを返す関数
  * @return LOSが通っているならTRUEを返す。
- * @details
- * A simple, fast, integer-based line-of-sight algorithm.  By Joseph Hall,\n
- * 4116 Brewster Drive, Raleigh NC 27606.  Email to jnh@ecemwl.ncsu.edu.\n
- *\n
- * Returns TRUE if a line of sight can be traced from (x1,y1) to (x2,y2).\n
- *\n
- * The LOS begins at the center of the tile (x1,y1) and ends at the center of\n
- * the tile (x2,y2).  If los() is to return TRUE, all of the tiles this line\n
- * passes through must be floor tiles, except for (x1,y1) and (x2,y2).\n
- *\n
- * We assume that the "mathematical corner" of a non-floor tile does not\n
- * block line of sight.\n
- *\n
- * Because this function uses (short) ints for all calculations, overflow may\n
- * occur if dx and dy exceed 90.\n
- *\n
- * Once all the degenerate cases are eliminated, the values "qx", "qy", and\n
- * "m" are multiplied by a scale factor "f1 = abs(dx * dy * 2)", so that\n
- * we can use integer arithmetic.\n
- *\n
- * We travel from start to finish along the longer axis, starting at the border\n
- * between the first and second tiles, where the y offset = .5 * slope, taking\n
- * into account the scale factor.  See below.\n
- *\n
- * Also note that this function and the "move towards target" code do NOT\n
- * share the same properties.  Thus, you can see someone, target them, and\n
- * then fire a bolt at them, but the bolt may hit a wall, not them.  However\n,
- * by clever choice of target locations, you can sometimes throw a "curve".\n
- *\n
- * Note that "line of sight" is not "reflexive" in all cases.\n
- *\n
- * Use the "projectable()" routine to test "spell/missile line of sight".\n
- *\n
- * Use the "update_view()" function to determine player line-of-sight.\n
+ * @details 辿るマスは地形によらず始点と終点の相対位置だけで決まる.
  */
-bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION x2)
+template <typename Func>
+static bool trace_los(POSITION y1, POSITION x1, POSITION y2, POSITION x2, Func &&is_open)
 {
     POSITION dy = y2 - y1;
     POSITION dx = x2 - x1;
@@ -57,13 +22,12 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
     }
 
     /* Directly South/North */
-    auto *floor_ptr = player_ptr->current_floor_ptr;
     POSITION tx, ty;
     if (!dx) {
         /* South -- check for walls */
         if (dy > 0) {
             for (ty = y1 + 1; ty < y2; ty++) {
-                if (!cave_los_bold(floor_ptr, ty, x1)) {
+                if (!is_open(ty, x1)) {
                     return false;
                 }
             }
@@ -72,7 +36,7 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
         /* North -- check for walls */
         else {
             for (ty = y1 - 1; ty > y2; ty--) {
-                if (!cave_los_bold(floor_ptr, ty, x1)) {
+                if (!is_open(ty, x1)) {
                     return false;
                 }
             }
@@ -87,7 +51,7 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
         /* East -- check for walls */
         if (dx > 0) {
             for (tx = x1 + 1; tx < x2; tx++) {
-                if (!cave_los_bold(floor_ptr, y1, tx)) {
+                if (!is_open(y1, tx)) {
                     return false;
                 }
             }
@@ -96,7 +60,7 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
         /* West -- check for walls */
         else {
             for (tx = x1 - 1; tx > x2; tx--) {
-                if (!cave_los_bold(floor_ptr, y1, tx)) {
+                if (!is_open(y1, tx)) {
                     return false;
                 }
             }
@@ -110,13 +74,13 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
 
     if (ax == 1) {
         if (ay == 2) {
-            if (cave_los_bold(floor_ptr, y1 + sy, x1)) {
+            if (is_open(y1 + sy, x1)) {
                 return true;
             }
         }
     } else if (ay == 1) {
         if (ax == 2) {
-            if (cave_los_bold(floor_ptr, y1, x1 + sx)) {
+            if (is_open(y1, x1 + sx)) {
                 return true;
             }
         }
@@ -140,7 +104,7 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
         /* Note (below) the case (qy == f2), where */
         /* the LOS exactly meets the corner of a tile. */
         while (x2 - tx) {
-            if (!cave_los_bold(floor_ptr, ty, tx)) {
+            if (!is_open(ty, tx)) {
                 return false;
             }
 
@@ -153,7 +117,7 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
 
             if (qy > f2) {
                 ty += sy;
-                if (!cave_los_bold(floor_ptr, ty, tx)) {
+                if (!is_open(ty, tx)) {
                     return false;
                 }
                 qy -= f1;
@@ -183,7 +147,7 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
     /* Note (below) the case (qx == f2), where */
     /* the LOS exactly meets the corner of a tile. */
     while (y2 - ty) {
-        if (!cave_los_bold(floor_ptr, ty, tx)) {
+        if (!is_open(ty, tx)) {
             return false;
         }
 
@@ -196,7 +160,7 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
 
         if (qx > f2) {
             tx += sx;
-            if (!cave_los_bold(floor_ptr, ty, tx)) {
+            if (!is_open(ty, tx)) {
                 return false;
             }
             qx -= f1;
@@ -211,3 +175,78 @@ bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION
 
     return true;
 }
+
+/*!
+ * @brief LOS(Line Of Sight / 視線が通っているか)の判定を行う。
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param y1 始点のy座標
+ * @param x1 始点のx座標
+ * @param y2 終点のy座標
+ * @param x2 終点のx座標
+ * @return LOSが通っているならTRUEを返す。
+ * @details
+ * A simple, fast, integer-based line-of-sight algorithm.  By Joseph Hall,\n
+ * 4116 Brewster Drive, Raleigh NC 27606.  Email to jnh@ecemwl.ncsu.edu.\n
+ *\n
+ * Returns TRUE if a line of sight can be traced from (x1,y1) to (x2,y2).\n
+ *\n
+ * The LOS begins at the center of the tile (x1,y1) and ends at the center of\n
+ * the tile (x2,y2).  If los() is to return TRUE, all of the tiles this line\n
+ * passes through must be floor tiles, except for (x1,y1) and (x2,y2).\n
+ *\n
+ * We assume that the "mathematical corner" of a non-floor tile does not\n
+ * block line of sight.\n
+ *\n
+ * Because this function uses (short) ints for all calculations, overflow may\n
+ * occur if dx and dy exceed 90.\n
+ *\n
+ * Once all the degenerate cases are eliminated, the values "qx", "qy", and\n
+ * "m" are multiplied by a scale factor "f1 = abs(dx * dy * 2)", so that\n
+ * we can use integer arithmetic.\n
+ *\n
+ * We travel from start to finish along the longer axis, starting at the border\n
+ * between the first and second tiles, where the y offset = .5 * slope, taking\n
+ * into account the scale factor.  See below.\n
+ *\n
+ * Also note that this function and the "move towards target" code do NOT\n
+ * share the same properties.  Thus, you can see someone, target them, and\n
+ * then fire a bolt at them, but the bolt may hit a wall, not them.  However\n,
+ * by clever choice of target locations, you can sometimes throw a "curve".\n
+ *\n
+ * Note that "line of sight" is not "reflexive" in all cases.\n
+ *\n
+ * Use the "projectable()" routine to test "spell/missile line of sight".\n
+ *\n
+ * Use the "update_view()" function to determine player line-of-sight.\n
+ */
+bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION x2)
+{
+    if ((std::abs(y2 - y1) < 2) && (std::abs(x2 - x1) < 2)) {
+        return true;
+    }
+
+    auto *floor_ptr = player_ptr->current_floor_ptr;
+    const auto cached = LineOfSightCache::get_instance().los(*floor_ptr, { y1, x1 }, { y2, x2 });
+    if (cached) {
+        return *cached;
+    }
+
+    return trace_los(y1, x1, y2, x2, [floor_ptr](POSITION y, POSITION x) { return cave_los_bold(floor_ptr, y, x); });
+}
+
+/*!
+ * @brief 視線の判定で調べるマスを列挙する
+ * @param dy 終点の始点からの相対Y座標
+ * @param dx 終点の始点からの相対X座標
+ * @return 始点からの相対座標の一覧
+ * @details 一覧の全てのマスが光を通す時に限り、los() はTRUEを返す.
+ */
+std::vector<Pos2D> get_los_grids(POSITION dy, POSITION dx)
+{
+    std::vector<Pos2D> grids;
+    trace_los(0, 0, dy, dx, [&grids](POSITION y, POSITION x) {
+        grids.emplace_back(y, x);
+        return true;
+    });
+    return grids;
+}
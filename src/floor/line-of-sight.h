@@ -1,6 +1,9 @@
 #pragma once
 
 #include "system/angband.h"
+#include "util/point-2d.h"
+#include <vector>
 
 class PlayerType;
 bool los(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION x2);
+std::vector<Pos2D> get_los_grids(POSITION dy, POSITION dx);
@@ -9,3 +9,4 @@ bool arg_monochrome; /* Command arg -- Request monochrome mode */
 bool arg_force_original; /* Command arg -- Request original keyset */
 bool arg_force_roguelike; /* Command arg -- Request roguelike keyset */
 bool arg_bigtile = false; /* Command arg -- Request big tile mode */
+int arg_frame_budget_msec = 16; /* Command arg -- Minimum interval of screen refresh during repeated actions (0 to refresh every turn) */
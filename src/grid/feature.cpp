@@ -2,6 +2,7 @@
 #include "dungeon/dungeon-flag-types.h"
 #include "floor/cave.h"
 #include "floor/geometry.h"
+#include "floor/line-of-sight-cache.h"
 #include "game-option/map-screen-options.h"
 #include "grid/grid.h"
 #include "grid/lighting-colors-table.h"
@@ -221,6 +222,7 @@ void cave_set_feat(PlayerType *player_ptr, POSITION y, POSITION x, FEAT_IDX feat
     g_ptr->mimic = 0;
     g_ptr->feat = feat;
     g_ptr->info &= ~(CAVE_OBJECT);
+    LineOfSightCache::get_instance().update_grid(*floor_ptr, { y, x });
     if (old_mirror && dungeon.flags.has(DungeonFeatureType::DARKNESS)) {
         g_ptr->info &= ~(CAVE_GLOW);
         if (!view_torch_grids) {
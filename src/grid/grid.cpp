@@ -24,6 +24,7 @@
 #include "floor/cave.h"
 #include "floor/floor-generator.h"
 #include "floor/geometry.h"
+#include "floor/line-of-sight-cache.h"
 #include "game-option/game-play-options.h"
 #include "game-option/map-screen-options.h"
 #include "game-option/special-options.h"
@@ -355,6 +356,10 @@ void note_spot(PlayerType *player_ptr, POSITION y, POSITION x)
     /* Hack -- memorize objects */
     for (const auto this_o_idx : grid.o_idx_list) {
         auto &item = floor.o_list[this_o_idx];
+        if (item.marked.has(OmType::FOUND)) {
+            continue;
+        }
+
         item.marked.set(OmType::FOUND);
         RedrawingFlagsUpdater::get_instance().set_flag(SubWindowRedrawingFlag::FOUND_ITEMS);
     }
@@ -409,6 +414,7 @@ void note_spot(PlayerType *player_ptr, POSITION y, POSITION x)
  */
 void lite_spot(PlayerType *player_ptr, POSITION y, POSITION x)
 {
+    mark_overview_spot(y, x);
     if (panel_contains(y, x) && in_bounds2(player_ptr->current_floor_ptr, y, x)) {
         TERM_COLOR a;
         char c;
@@ -1065,6 +1071,11 @@ void place_grid(PlayerType *player_ptr, Grid *g_ptr, grid_bold_type gb_type)
     if (g_ptr->m_idx > 0) {
         delete_monster_idx(player_ptr, g_ptr->m_idx);
     }
+
+    // 座標が分からないため、ゲーム中に呼ばれた時は視線キャッシュを作り直させる
+    if (w_ptr->character_dungeon) {
+        LineOfSightCache::get_instance().invalidate();
+    }
 }
 
 /*!
@@ -1087,6 +1098,7 @@ void place_bold(PlayerType *player_ptr, POSITION y, POSITION x, grid_bold_type g
 void set_cave_feat(FloorType *floor_ptr, POSITION y, POSITION x, FEAT_IDX feature_idx)
 {
     floor_ptr->grid_array[y][x].feat = feature_idx;
+    LineOfSightCache::get_instance().update_grid(*floor_ptr, { y, x });
 }
 
 /*!
@@ -7,6 +7,7 @@
 #include "effect/effect-processor.h"
 #include "floor/cave.h"
 #include "floor/floor-mode-changer.h"
+#include "floor/line-of-sight-cache.h"
 #include "game-option/birth-options.h"
 #include "game-option/special-options.h"
 #include "grid/feature.h"
@@ -230,6 +231,7 @@ void place_trap(FloorType *floor_ptr, POSITION y, POSITION x)
     /* Place an invisible trap */
     g_ptr->mimic = g_ptr->feat;
     g_ptr->feat = choose_random_trap(floor_ptr);
+    LineOfSightCache::get_instance().update_grid(*floor_ptr, { y, x });
 }
 
 /*!
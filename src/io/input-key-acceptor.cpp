@@ -1,5 +1,6 @@
 #include "io/input-key-acceptor.h"
 #include "cmd-io/macro-util.h"
+#include "core/frame-pacer.h"
 #include "core/stuff-handler.h"
 #include "core/window-redrawer.h"
 #include "game-option/input-options.h"
@@ -62,6 +63,22 @@ static void all_term_fresh()
     term_fresh();
 }
 
+/*!
+ * @brief 連続行動中に見送った描画が残っていれば、カーソル位置を保ったまま描画する
+ */
+static void draw_deferred_frame()
+{
+    TERM_LEN x, y;
+    term_activate(angband_terms[0]);
+    term_locate(&x, &y);
+    if (!FramePacer::get_instance().draw_deferred_frame(p_ptr)) {
+        return;
+    }
+
+    term_activate(angband_terms[0]);
+    term_gotoxy(x, y);
+}
+
 /*
  * Cancel macro action on the queue
  */
@@ -240,6 +257,7 @@ char inkey(bool do_all_term_refresh)
 
         if (!done && (0 != term_inkey(&kk, false, false))) {
             start_term_fresh();
+            draw_deferred_frame();
             if (do_all_term_refresh) {
                 all_term_fresh();
             } else {
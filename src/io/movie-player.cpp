@@ -0,0 +1,378 @@
+/*!
+ * @brief 録画したムービーの頭出し再生と書き出し
+ * @details
+ * ムービーは'\0'で区切ったレコードの並びで、'd'レコードがフレームの区切りになる.
+ * 録画時に一定間隔で'k'から'K'までのキーフレームを挟む. キーフレームは読み込み時の走査で見つける.
+ */
+
+#include "io/movie-player.h"
+#include "locale/japanese.h"
+#include "term/gameterm.h"
+#include "term/term-color-types.h"
+#include "term/z-term.h"
+#include "util/angband-files.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+MovieScreen::MovieScreen()
+    : width(MAIN_TERM_MIN_COLS)
+    , height(MAIN_TERM_MIN_ROWS)
+{
+    this->clear();
+}
+
+TERM_COLOR MovieScreen::get_attr(int x, int y) const
+{
+    return this->attrs[y * this->width + x];
+}
+
+char MovieScreen::get_char(int x, int y) const
+{
+    return this->chars[y * this->width + x];
+}
+
+void MovieScreen::clear()
+{
+    this->attrs.assign(this->width * this->height, TERM_WHITE);
+    this->chars.assign(this->width * this->height, ' ');
+}
+
+/*!
+ * @brief レコードを1つ適用する
+ * @param record '\0'を含まないレコード
+ * @details 再生時の flush_ringbuf_client() と同じく、範囲外への描画があれば画面を広げる.
+ */
+void MovieScreen::apply(std::string_view record)
+{
+    if (record.length() < 2) {
+        return;
+    }
+
+    const auto id = record[0];
+    const auto x = static_cast<uint8_t>(record[1]) - 1;
+    if (id == 'x') {
+        if (x == TERM_XTRA_CLEAR) {
+            this->clear();
+        }
+
+        return;
+    }
+
+    if (record.length() < 3) {
+        return;
+    }
+
+    const auto y = static_cast<uint8_t>(record[2]) - 1;
+    switch (id) {
+    case 't': {
+        if (record.length() < 5) {
+            return;
+        }
+
+        const int len = std::min<int>(static_cast<uint8_t>(record[3]), record.length() - 5);
+        this->reserve(x, y, len);
+        for (auto i = 0; i < len; i++) {
+            this->put(x + i, y, record[4], record[5 + i]);
+        }
+
+        return;
+    }
+    case 'n': {
+        if (record.length() < 6) {
+            return;
+        }
+
+        const int len = static_cast<uint8_t>(record[3]);
+        this->reserve(x, y, len);
+        for (auto i = 0; i < len; i++) {
+            this->put(x + i, y, record[4], record[5]);
+        }
+
+        return;
+    }
+    case 's':
+        if (record.length() < 5) {
+            return;
+        }
+
+        this->reserve(x, y, 1);
+        this->put(x, y, record[3], record[4]);
+        return;
+    case 'w': {
+        if (record.length() < 4) {
+            return;
+        }
+
+        const int len = static_cast<uint8_t>(record[3]);
+        this->reserve(x, y, len);
+        for (auto i = 0; i < len; i++) {
+            this->put(x + i, y, TERM_WHITE, ' ');
+        }
+
+        return;
+    }
+    case 'c':
+    case 'C':
+        this->reserve(x, y, 1);
+        this->cursor_visible = true;
+        this->cursor_x = x;
+        this->cursor_y = y;
+        return;
+    default:
+        return;
+    }
+}
+
+void MovieScreen::reserve(int x, int y, int len)
+{
+    const auto new_width = std::max(this->width, x + len);
+    const auto new_height = std::max(this->height, y + 1);
+    if ((new_width == this->width) && (new_height == this->height)) {
+        return;
+    }
+
+    std::vector<TERM_COLOR> new_attrs(new_width * new_height, TERM_WHITE);
+    std::vector<char> new_chars(new_width * new_height, ' ');
+    for (auto row = 0; row < this->height; row++) {
+        std::copy_n(&this->attrs[row * this->width], this->width, &new_attrs[row * new_width]);
+        std::copy_n(&this->chars[row * this->width], this->width, &new_chars[row * new_width]);
+    }
+
+    this->attrs = std::move(new_attrs);
+    this->chars = std::move(new_chars);
+    this->width = new_width;
+    this->height = new_height;
+}
+
+void MovieScreen::put(int x, int y, TERM_COLOR attr, char ch)
+{
+    this->attrs[y * this->width + x] = attr;
+    this->chars[y * this->width + x] = ch;
+}
+
+/*!
+ * @brief ムービーを読み込み、フレームの境界とキーフレームの位置を調べる
+ * @param path ムービーファイルのパス
+ */
+MoviePlayer::MoviePlayer(const std::filesystem::path &path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) {
+        return;
+    }
+
+    this->data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    this->scan_frames();
+}
+
+bool MoviePlayer::is_loaded() const
+{
+    return !this->frames.empty();
+}
+
+int MoviePlayer::get_frame_count() const
+{
+    return static_cast<int>(this->frames.size());
+}
+
+int MoviePlayer::get_current_frame() const
+{
+    return this->current_frame;
+}
+
+/*!
+ * @brief フレームの時刻を返す
+ * @return 録画開始からの経過時間(100ms単位). フレームが存在しなければ0
+ */
+int MoviePlayer::get_frame_time(int frame) const
+{
+    if ((frame < 0) || (frame >= this->get_frame_count())) {
+        return 0;
+    }
+
+    return this->frames[frame].time;
+}
+
+/*!
+ * @brief 指定の時刻に表示されていたフレームを探す
+ * @param time 録画開始からの経過時間(100ms単位)
+ * @return フレームの番号. 最初のフレームより前なら最初のフレーム
+ */
+int MoviePlayer::find_frame(int time) const
+{
+    const auto it = std::upper_bound(this->frames.begin(), this->frames.end(), time, [](int t, const movie_frame &frame) { return t < frame.time; });
+    return std::max(0, static_cast<int>(std::distance(this->frames.begin(), it)) - 1);
+}
+
+const MovieScreen &MoviePlayer::get_screen() const
+{
+    return this->screen;
+}
+
+/*!
+ * @brief 指定のフレームの画面を作る
+ * @param frame フレームの番号
+ * @return フレームが存在したか
+ * @details 今の位置から進める方が近い場合を除き、手前で最も近いキーフレームから作り直す.
+ */
+bool MoviePlayer::seek_frame(int frame)
+{
+    if ((frame < 0) || (frame >= this->get_frame_count())) {
+        return false;
+    }
+
+    const auto it = std::upper_bound(this->keyframes.begin(), this->keyframes.end(), frame, [](int f, const auto &keyframe) { return f < keyframe.first; });
+    const auto keyframe_frame = (it == this->keyframes.begin()) ? -1 : std::prev(it)->first;
+    if ((this->current_frame > frame) || (this->current_frame < keyframe_frame)) {
+        this->screen = MovieScreen();
+        this->current_frame = -1;
+        this->current_offset = 0;
+        if (it != this->keyframes.begin()) {
+            this->current_offset = this->apply_keyframe(std::prev(it)->second);
+            this->current_frame = keyframe_frame;
+        }
+    }
+
+    this->apply_records(this->current_offset, this->frames[frame].end);
+    this->current_offset = this->frames[frame].end;
+    this->current_frame = frame;
+    return true;
+}
+
+bool MoviePlayer::seek_time(int time)
+{
+    return this->seek_frame(this->find_frame(time));
+}
+
+bool MoviePlayer::step_forward()
+{
+    return this->seek_frame(this->current_frame + 1);
+}
+
+bool MoviePlayer::step_backward()
+{
+    return this->seek_frame(this->current_frame - 1);
+}
+
+/*!
+ * @brief フレームの画面をテキストで書き出す
+ * @param path 書き出すファイルのパス
+ * @param first 最初のフレームの番号
+ * @param last 最後のフレームの番号
+ * @return 書き出せたか
+ * @details 書き出した後は最後のフレームを表示している状態になる.
+ */
+bool MoviePlayer::export_frames(const std::filesystem::path &path, int first, int last)
+{
+    first = std::max(first, 0);
+    last = std::min(last, this->get_frame_count() - 1);
+    if (first > last) {
+        return false;
+    }
+
+    auto *fff = angband_fopen(path, FileOpenMode::WRITE);
+    if (!fff) {
+        return false;
+    }
+
+    for (auto frame = first; frame <= last; frame++) {
+        this->seek_frame(frame);
+        const auto time = this->get_frame_time(frame);
+        fprintf(fff, "[Frame %d: %d:%02d.%d]\n", frame, time / 600, time / 10 % 60, time % 10);
+        for (auto y = 0; y < this->screen.height; y++) {
+            std::string line;
+            for (auto x = 0; x < this->screen.width; x++) {
+                line.push_back(this->screen.get_char(x, y));
+            }
+
+            line.erase(line.find_last_not_of(' ') + 1);
+#if defined(SJIS) && defined(JP)
+            euc2sjis(line.data());
+#endif
+            fprintf(fff, "%s\n", line.data());
+        }
+
+        fprintf(fff, "\n");
+    }
+
+    angband_fclose(fff);
+    return true;
+}
+
+/*!
+ * @brief フレームの境界を調べ、キーフレームの位置をフレームの番号に対応付ける
+ */
+void MoviePlayer::scan_frames()
+{
+    for (size_t offset = 0; offset < this->data.size();) {
+        const auto record = this->get_record(offset);
+        const auto next = offset + record.length() + 1;
+        if (next > this->data.size()) {
+            break;
+        }
+
+        if (record.starts_with('d')) {
+            this->frames.push_back({ std::atoi(record.data() + 1), next });
+        } else if (record.starts_with('k') && !this->frames.empty()) {
+            this->keyframes.emplace_back(this->get_frame_count() - 1, offset);
+        }
+
+        offset = next;
+    }
+}
+
+/*!
+ * @brief キーフレームを空の画面に適用する
+ * @param offset キーフレームの'k'レコードの位置
+ * @return キーフレームの直後の位置
+ */
+size_t MoviePlayer::apply_keyframe(size_t offset)
+{
+    auto record = this->get_record(offset);
+    offset += record.length() + 1;
+    while (offset < this->data.size()) {
+        record = this->get_record(offset);
+        offset += record.length() + 1;
+        if (record.starts_with('K')) {
+            break;
+        }
+
+        this->screen.apply(record);
+    }
+
+    return offset;
+}
+
+/*!
+ * @brief 範囲内のレコードを順に適用する
+ * @details キーフレームは直前のフレームと同じ画面を描き直すだけなので読み飛ばす.
+ */
+void MoviePlayer::apply_records(size_t begin, size_t end)
+{
+    auto in_keyframe = false;
+    for (auto offset = begin; offset < end;) {
+        const auto record = this->get_record(offset);
+        offset += record.length() + 1;
+        if (record.starts_with('k')) {
+            in_keyframe = true;
+        } else if (record.starts_with('K')) {
+            in_keyframe = false;
+        } else if (!in_keyframe) {
+            this->screen.apply(record);
+        }
+    }
+}
+
+/*!
+ * @brief 指定の位置から始まるレコードを返す
+ * @details 終端の'\0'が無い場合はファイルの末尾までをレコードとみなす.
+ */
+std::string_view MoviePlayer::get_record(size_t offset) const
+{
+    const auto *begin = this->data.data() + offset;
+    const auto *terminator = std::find(begin, this->data.data() + this->data.size(), '\0');
+    return std::string_view(begin, terminator - begin);
+}
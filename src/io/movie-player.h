@@ -0,0 +1,76 @@
+#pragma once
+
+#include "system/angband.h"
+#include <filesystem>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*!
+ * @brief ムービーの1画面分の内容
+ */
+class MovieScreen {
+public:
+    MovieScreen();
+
+    int width;
+    int height;
+    bool cursor_visible = false;
+    int cursor_x = 0;
+    int cursor_y = 0;
+
+    TERM_COLOR get_attr(int x, int y) const;
+    char get_char(int x, int y) const;
+    void clear();
+    void apply(std::string_view record);
+
+private:
+    std::vector<TERM_COLOR> attrs{};
+    std::vector<char> chars{};
+
+    void reserve(int x, int y, int len);
+    void put(int x, int y, TERM_COLOR attr, char ch);
+};
+
+/*!
+ * @brief 録画したムービーを任意の位置から再生する
+ * @details
+ * 読み込み時にレコードの区切りだけを走査してフレームの境界を記録し、描画の内容はまだ解釈しない.
+ * 指定のフレームへ移る時は、その手前で最も近いキーフレームの画面から差分だけを適用する.
+ * キーフレームを含まない古い形式のムービーは先頭から適用する.
+ */
+class MoviePlayer {
+public:
+    explicit MoviePlayer(const std::filesystem::path &path);
+
+    bool is_loaded() const;
+    int get_frame_count() const;
+    int get_current_frame() const;
+    int get_frame_time(int frame) const;
+    int find_frame(int time) const;
+    const MovieScreen &get_screen() const;
+    bool seek_frame(int frame);
+    bool seek_time(int time);
+    bool step_forward();
+    bool step_backward();
+    bool export_frames(const std::filesystem::path &path, int first, int last);
+
+private:
+    /* フレームの時刻と、そのフレームの最後のレコードの直後の位置 */
+    struct movie_frame {
+        int time;
+        size_t end;
+    };
+
+    std::vector<char> data{};
+    std::vector<movie_frame> frames{};
+    std::vector<std::pair<int, size_t>> keyframes{}; /* キーフレームが再現するフレームと、キーフレームの位置 */
+    MovieScreen screen{};
+    int current_frame = -1;
+    size_t current_offset = 0;
+
+    void scan_frames();
+    size_t apply_keyframe(size_t offset);
+    void apply_records(size_t begin, size_t end);
+    std::string_view get_record(size_t offset) const;
+};
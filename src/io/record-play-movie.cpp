@@ -9,14 +9,20 @@
 #include "cmd-visual/cmd-draw.h"
 #include "core/asking-player.h"
 #include "io/files-util.h"
+#include "io/input-key-acceptor.h"
+#include "io/movie-player.h"
 #include "io/signal-handlers.h"
 #include "locale/japanese.h"
 #include "system/player-type-definition.h"
 #include "term/gameterm.h"
+#include "term/screen-processor.h"
 #include "term/z-form.h"
+#include "term/z-term.h"
 #include "util/angband-files.h"
+#include "util/int-char-converter.h"
 #include "view/display-messages.h"
 #include <algorithm>
+#include <optional>
 #include <sstream>
 #include <vector>
 
@@ -37,11 +43,16 @@
 #define RECVBUF_SIZE 1024
 /* 「n」、「t」、および「w」コマンドでは、長さが「signed char」に配置されるときに負の値を回避するために、これよりも長い長さを使用しないでください。 */
 static constexpr auto SPLIT_MAX = 127;
+static constexpr size_t MOVIE_FLUSH_SIZE = 64 * 1024; /* 録画バッファをファイルへ書き出す量 */
+static constexpr auto MOVIE_FLUSH_INTERVAL = 50; /* 録画バッファを書き出す最大の間隔(100ms単位) */
+static constexpr auto KEYFRAME_INTERVAL = 100; /* キーフレームを記録する間隔(100ms単位) */
+static constexpr long KEYFRAME_SIZE = 128 * 1024; /* キーフレームの間に記録する最大の量 */
 
 static long epoch_time; /* バッファ開始時刻 */
 static int browse_delay; /* 表示するまでの時間(100ms単位)(この間にラグを吸収する) */
 static int movie_fd;
 static int movie_mode;
+static std::filesystem::path movie_path; /* 再生中のムービーファイル */
 
 /* 描画する時刻を覚えておくキュー構造体 */
 static struct {
@@ -58,6 +69,21 @@ static struct {
     int inlen = 0;
 } ring;
 
+/*!
+ * @brief 録画バッファ構造体
+ * @details 描画フックごとにファイルへ書き込む代わりにメモリへ溜め、まとめて書き出す.
+ */
+struct movie_record_buffer {
+    std::vector<char> buf{};
+    std::optional<int> last_keyframe_time{}; /* 最後に記録したキーフレームの時刻 */
+    long last_keyframe_offset = 0; /* 最後に記録したキーフレームの位置 */
+    long written = 0; /* ファイルへ書き出したバイト数 */
+    long frame_start = 0; /* 記録中のフレームの開始位置 */
+    int last_flush_time = 0;
+};
+
+static movie_record_buffer recorder;
+
 /*
  * Original hooks
  */
@@ -99,6 +125,23 @@ static long get_current_time(void)
 #endif
 }
 
+/* 録画ファイル上での次のレコードの位置を返す */
+static long get_record_offset(void)
+{
+    return recorder.written + static_cast<long>(recorder.buf.size());
+}
+
+static void flush_movie_buffer(int time)
+{
+    if (!recorder.buf.empty()) {
+        (void)fd_write(movie_fd, recorder.buf.data(), recorder.buf.size());
+        recorder.written += static_cast<long>(recorder.buf.size());
+        recorder.buf.clear();
+    }
+
+    recorder.last_flush_time = time;
+}
+
 /*!
  * @brief リングバッファにヘッダとペイロードを追加する
  * @param header ヘッダ
@@ -108,11 +151,9 @@ static long get_current_time(void)
 static errr insert_ringbuf(std::string_view header, std::string_view payload = "")
 {
     if (movie_mode) {
-        fd_write(movie_fd, header.data(), header.length());
-        if (!payload.empty()) {
-            fd_write(movie_fd, payload.data(), payload.length());
-        }
-        fd_write(movie_fd, "", 1);
+        recorder.buf.insert(recorder.buf.end(), header.begin(), header.end());
+        recorder.buf.insert(recorder.buf.end(), payload.begin(), payload.end());
+        recorder.buf.push_back('\0');
         return 0;
     }
 
@@ -215,11 +256,15 @@ static int find_split(concptr str, int len)
 }
 #endif
 
-static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
+/*!
+ * @brief 文字列の描画を記録する
+ * @details 分割した時に元の描画フックへ渡す引数が書き換わらないよう、記録と描画を分けている.
+ */
+static void record_text(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
 {
     if (len == 1) {
         insert_ringbuf(format("s%c%c%c%c", x + 1, y + 1, col, *str));
-        return (*old_text_hook)(x, y, len, col, str);
+        return;
     }
 
     if (string_is_repeat(str, len)) {
@@ -237,11 +282,11 @@ static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_CO
         }
 
         insert_ringbuf(formatted_text);
-        return (*old_text_hook)(x, y, len, col, str);
+        return;
     }
 
 #if defined(SJIS) && defined(JP)
-    std::string buffer = str; // strは書き換わって欲しくないのでコピーする.
+    std::string buffer(str, len); // strは書き換わって欲しくないのでコピーする.
     auto *payload = buffer.data();
     sjis2euc(payload);
 #else
@@ -256,10 +301,9 @@ static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_CO
     }
 
     insert_ringbuf(format("t%c%c%c%c", x + 1, y + 1, len, col), std::string_view(payload, len));
-    return (*old_text_hook)(x, y, len, col, str);
 }
 
-static errr send_wipe_to_chuukei_server(int x, int y, int len)
+static void record_wipe(int x, int y, int len)
 {
     while (len > SPLIT_MAX) {
         insert_ringbuf(format("w%c%c%c", x + 1, y + 1, SPLIT_MAX));
@@ -267,18 +311,132 @@ static errr send_wipe_to_chuukei_server(int x, int y, int len)
         len -= SPLIT_MAX;
     }
     insert_ringbuf(format("w%c%c%c", x + 1, y + 1, len));
+}
+
+/*!
+ * @brief 画面に保持している属性から文字の色を取り出す
+ * @details 全角文字の1バイト目と2バイト目の印を取り除き、描画フックへ渡される色と揃える.
+ */
+static TERM_COLOR get_cell_color(TERM_COLOR a)
+{
+#ifdef JP
+    return a & AF_KANJIC;
+#else
+    return a;
+#endif
+}
+
+/*!
+ * @brief 空白として記録するマスか調べる
+ * @details 色0の文字は区切りの'\0'と衝突するため、タイルは録画の対象外のため空白とみなす.
+ */
+static bool is_blank_cell(TERM_COLOR a, char c)
+{
+    return (c == ' ') || (get_cell_color(a) == 0) || ((a & AF_TILE1) && (c & 0x80));
+}
+
+/*!
+ * @brief 画面全体をキーフレームとして記録する
+ * @param time キーフレームの時刻
+ * @details 'k'から'K'までのレコードを空の画面に適用すると、その時点の画面が再現される.
+ * 途中から再生する時はここから読み始める. 先頭から順に再生する時は同じ内容を描き直すだけになる.
+ */
+static void record_keyframe(int time)
+{
+    recorder.last_keyframe_time = time;
+    recorder.last_keyframe_offset = get_record_offset();
+    insert_ringbuf("k", std::to_string(time));
+
+    const auto *screen = game_term->old.get();
+    const auto &[wid, hgt] = term_get_size();
+    for (auto y = 0; y < hgt; y++) {
+        const auto *aa = screen->a[y];
+        const auto *cc = screen->c[y];
+        auto x = 0;
+        while (x < wid) {
+            auto end = x + 1;
+            if (is_blank_cell(aa[x], cc[x])) {
+                while ((end < wid) && is_blank_cell(aa[end], cc[end])) {
+                    end++;
+                }
+
+                record_wipe(x, y, end - x);
+                x = end;
+                continue;
+            }
 
+            const auto color = get_cell_color(aa[x]);
+            while ((end < wid) && (get_cell_color(aa[end]) == color) && ((cc[end] == ' ') || !is_blank_cell(aa[end], cc[end]))) {
+                end++;
+            }
+
+#ifdef JP
+            /* 全角文字の2バイト目は色に関わらず1バイト目と同じ't'に含める */
+            if ((end < wid) && (aa[end] & AF_KANJI2) && !(aa[end] & AF_TILE1)) {
+                end++;
+            }
+#endif
+
+            auto text_end = end;
+            while (cc[text_end - 1] == ' ') {
+                text_end--;
+            }
+
+            record_text(x, y, text_end - x, color, &cc[x]);
+            x = text_end;
+        }
+    }
+
+    if (screen->cv && !screen->cu) {
+        insert_ringbuf(format("c%c%c", screen->cx + 1, screen->cy + 1));
+    }
+
+    insert_ringbuf("K");
+}
+
+/*!
+ * @brief 1フレーム分の描画の終わりを記録する
+ * @details 何も描画していないフレームは記録しない. 一定時間ごと、または一定量を記録するごとにキーフレームを挟み、
+ * バッファが溜まったらファイルへ書き出す.
+ */
+static void record_frame_end()
+{
+    if (get_record_offset() == recorder.frame_start) {
+        return;
+    }
+
+    const int time = get_current_time() - epoch_time;
+    insert_ringbuf(format("x%c", TERM_XTRA_FRESH + 1));
+    insert_ringbuf("d", std::to_string(time));
+    const auto is_keyframe_due = !recorder.last_keyframe_time || (time - *recorder.last_keyframe_time >= KEYFRAME_INTERVAL);
+    if (is_keyframe_due || (get_record_offset() - recorder.last_keyframe_offset >= KEYFRAME_SIZE)) {
+        record_keyframe(time);
+    }
+
+    recorder.frame_start = get_record_offset();
+    if ((recorder.buf.size() >= MOVIE_FLUSH_SIZE) || (time - recorder.last_flush_time >= MOVIE_FLUSH_INTERVAL)) {
+        flush_movie_buffer(time);
+    }
+}
+
+static errr send_text_to_chuukei_server(TERM_LEN x, TERM_LEN y, int len, TERM_COLOR col, concptr str)
+{
+    record_text(x, y, len, col, str);
+    return (*old_text_hook)(x, y, len, col, str);
+}
+
+static errr send_wipe_to_chuukei_server(int x, int y, int len)
+{
+    record_wipe(x, y, len);
     return (*old_wipe_hook)(x, y, len);
 }
 
 static errr send_xtra_to_chuukei_server(int n, int v)
 {
-    if (n == TERM_XTRA_CLEAR || n == TERM_XTRA_FRESH || n == TERM_XTRA_SHAPE) {
+    if (n == TERM_XTRA_FRESH) {
+        record_frame_end();
+    } else if (n == TERM_XTRA_CLEAR || n == TERM_XTRA_SHAPE) {
         insert_ringbuf(format("x%c", n + 1));
-
-        if (n == TERM_XTRA_FRESH) {
-            insert_ringbuf("d", std::to_string(get_current_time() - epoch_time));
-        }
     }
 
     /* Verify the hook */
@@ -325,6 +483,60 @@ void prepare_chuukei_hooks(void)
     t0->text_hook = send_text_to_chuukei_server;
 }
 
+/*!
+ * @brief 録画ファイルを閉じる
+ * @details 書き出していないフレームを書き出してからファイルを閉じる.
+ */
+static void close_movie_file()
+{
+    flush_movie_buffer(get_current_time() - epoch_time);
+    movie_mode = 0;
+    fd_close(movie_fd);
+}
+
+/*!
+ * @brief 指定のファイルへ録画を始める
+ * @param path 録画ファイルのパス. 既に存在する時は上書きする
+ * @return 録画を始められたか
+ */
+bool start_movie_recording(const std::filesystem::path &path)
+{
+    movie_fd = fd_open(path, O_WRONLY | O_TRUNC);
+    if (movie_fd < 0) {
+        movie_fd = fd_make(path);
+    }
+
+    if (movie_fd < 0) {
+        return false;
+    }
+
+    recorder.buf.clear();
+    recorder.buf.reserve(MOVIE_FLUSH_SIZE * 2);
+    recorder.last_keyframe_time.reset();
+    recorder.last_keyframe_offset = 0;
+    recorder.written = 0;
+    recorder.frame_start = 0;
+    recorder.last_flush_time = 0;
+    epoch_time = get_current_time();
+    movie_mode = 1;
+    prepare_chuukei_hooks();
+    return true;
+}
+
+/*!
+ * @brief 録画中ならば録画を終える
+ * @details 録画したままゲームを終える時に、書き出していないフレームを失わないよう呼ぶ.
+ */
+void finish_movie_recording()
+{
+    if (!movie_mode) {
+        return;
+    }
+
+    close_movie_file();
+    disable_chuukei_server();
+}
+
 /*
  * Prepare z-term hooks to call send_*_to_chuukei_server()'s
  */
@@ -333,9 +545,7 @@ void prepare_movie_hooks(PlayerType *player_ptr)
     TermCenteredOffsetSetter tcos(std::nullopt, std::nullopt);
 
     if (movie_mode) {
-        movie_mode = 0;
-        disable_chuukei_server();
-        fd_close(movie_fd);
+        finish_movie_recording();
         msg_print(_("録画を終了しました。", "Stopped recording."));
         return;
     }
@@ -360,19 +570,13 @@ void prepare_movie_hooks(PlayerType *player_ptr)
         if (!input_check(query)) {
             return;
         }
-
-        movie_fd = fd_open(path, O_WRONLY | O_TRUNC);
-    } else {
-        movie_fd = fd_make(path);
     }
 
-    if (!movie_fd) {
+    if (!start_movie_recording(path)) {
         msg_print(_("ファイルを開けません！", "Can not open file."));
         return;
     }
 
-    movie_mode = 1;
-    prepare_chuukei_hooks();
     do_cmd_redraw(player_ptr);
 }
 
@@ -614,8 +818,132 @@ static bool flush_ringbuf_client()
     return true;
 }
 
+/*!
+ * @brief 頭出し再生で組み立てた画面を表示する
+ */
+static void draw_movie_screen(const MovieScreen &screen)
+{
+    update_term_size(0, screen.height - 1, screen.width);
+    term_clear();
+    for (auto y = 0; y < screen.height; y++) {
+        auto x = 0;
+        while (x < screen.width) {
+            const auto attr = screen.get_attr(x, y);
+            std::string text;
+            for (auto end = x; (end < screen.width) && (screen.get_attr(end, y) == attr); end++) {
+                text.push_back(screen.get_char(end, y));
+            }
+
+#ifndef WINDOWS
+            win2unix(attr, text.data());
+#endif
+#if defined(SJIS) && defined(JP)
+            euc2sjis(text.data());
+#endif
+            term_putstr(x, y, text.length(), attr, text);
+            x += text.length();
+        }
+    }
+
+    if (screen.cursor_visible) {
+        term_gotoxy(screen.cursor_x, screen.cursor_y);
+    }
+}
+
+/*!
+ * @brief 指定の範囲のフレームを書き出す
+ * @return 書き出したか
+ */
+static bool export_movie_frames(MoviePlayer &player, int first, int last)
+{
+    const auto filename = input_string(_("書き出すファイル名: ", "Export file name: "), 80, "movie.txt");
+    if (!filename) {
+        return false;
+    }
+
+    const auto current_frame = player.get_current_frame();
+    const auto is_exported = player.export_frames(path_build(ANGBAND_DIR_USER, *filename), first, last);
+    player.seek_frame(current_frame);
+    return is_exported;
+}
+
+/*!
+ * @brief ムービーを頭出ししながら見直す
+ * @param time 最初に表示する時刻
+ * @details キーフレームを使って任意の時刻やフレームへ直接移動し、表示中のフレームや範囲をテキストで書き出す.
+ */
+static void review_movie(int time)
+{
+    MoviePlayer player(movie_path);
+    if (!player.is_loaded() || !player.seek_time(time)) {
+        return;
+    }
+
+    std::string status = _("[n/p:前後 </>:10秒 g:時刻 e/E:書き出し ESC:終了]", "[n/p:Step </>:10 sec g:Go to e/E:Export ESC:Exit]");
+    while (true) {
+        const auto frame = player.get_current_frame();
+        const auto time = player.get_frame_time(frame);
+        draw_movie_screen(player.get_screen());
+        const auto &[wid, hgt] = term_get_size();
+        prt(format("%d/%d %d:%02d.%d %s", frame + 1, player.get_frame_count(), time / 600, time / 10 % 60, time % 10, status.data()), hgt - 1, 0);
+        status = "";
+        const auto key = inkey();
+        switch (key) {
+        case ESCAPE:
+        case 'q':
+            return;
+        case ' ':
+        case 'n':
+            player.step_forward();
+            break;
+        case 'p':
+        case 'b':
+            player.step_backward();
+            break;
+        case '>':
+            player.seek_time(time + 100);
+            break;
+        case '<':
+            player.seek_time(time - 100);
+            break;
+        case 'g': {
+            const auto last_time = player.get_frame_time(player.get_frame_count() - 1);
+            const auto seconds = input_integer(_("移動する時刻(秒)", "Time to go to (seconds)"), 0, last_time / 10, time / 10);
+            if (seconds) {
+                player.seek_time(*seconds * 10);
+            }
+
+            break;
+        }
+        case 'e':
+            if (export_movie_frames(player, frame, frame)) {
+                status = _("書き出しました。", "Exported.");
+            }
+
+            break;
+        case 'E': {
+            const auto last_frame = player.get_frame_count();
+            const auto first = input_integer(_("最初のフレーム", "First frame"), 1, last_frame, frame + 1);
+            if (!first) {
+                break;
+            }
+
+            const auto last = input_integer(_("最後のフレーム", "Last frame"), *first, last_frame, *first);
+            if (last && export_movie_frames(player, *first - 1, *last - 1)) {
+                status = _("書き出しました。", "Exported.");
+            }
+
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
 void prepare_browse_movie_without_path_build(const std::filesystem::path &path)
 {
+    movie_path = path;
     movie_fd = fd_open(path, O_RDONLY);
     init_buffer();
 }
@@ -626,18 +954,30 @@ void browse_movie(void)
     term_fresh();
     term_xtra(TERM_XTRA_REACT, 0);
 
+    auto shown_time = 0;
     while (read_movie_file() == 0) {
         while (fresh_queue.next != fresh_queue.tail) {
-            if (!flush_ringbuf_client()) {
-                term_xtra(TERM_XTRA_FLUSH, 0);
+            const auto time = fresh_queue.time[fresh_queue.next];
+            if (flush_ringbuf_client()) {
+                shown_time = time;
+                continue;
+            }
+
+            term_xtra(TERM_XTRA_FLUSH, 0);
 
-                /* ソケットにデータが来ているかどうか調べる */
+            /* キーが押されたら再生を止め、表示中のフレームから頭出しの操作に移る */
+            char key;
+            if (term_inkey(&key, false, true) == 0) {
+                review_movie(shown_time);
+                return;
+            }
+
+            /* ソケットにデータが来ているかどうか調べる */
 #ifdef WINDOWS
-                Sleep(WAIT);
+            Sleep(WAIT);
 #else
-                usleep(WAIT);
+            usleep(WAIT);
 #endif
-            }
         }
     }
 }
@@ -646,6 +986,7 @@ void browse_movie(void)
 void prepare_browse_movie_with_path_build(std::string_view filename)
 {
     const auto &path = path_build(ANGBAND_DIR_USER, filename);
+    movie_path = path;
     movie_fd = fd_open(path, O_RDONLY);
     init_buffer();
 }
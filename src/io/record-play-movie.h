@@ -5,6 +5,8 @@
 
 class PlayerType;
 void prepare_movie_hooks(PlayerType *player_ptr);
+bool start_movie_recording(const std::filesystem::path &path);
+void finish_movie_recording();
 void prepare_browse_movie_without_path_build(const std::filesystem::path &path);
 void browse_movie();
 #ifndef WINDOWS
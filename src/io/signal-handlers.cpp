@@ -10,6 +10,7 @@
 #include "core/game-closer.h"
 #include "floor/floor-events.h"
 #include "game-option/cheat-options.h"
+#include "io/record-play-movie.h"
 #include "io/write-diary.h"
 #include "monster-floor/monster-lite.h"
 #include "save/save.h"
@@ -148,6 +149,7 @@ static void handle_signal_abort(int sig)
     }
 
     term_fresh();
+    finish_movie_recording();
     quit(_("ソフトのバグ", "software bug"));
 }
 
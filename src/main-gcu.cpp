@@ -947,6 +947,26 @@ static errr game_term_xtra_gcu_react(void)
     return 0;
 }
 
+/*
+ * 画面への反映を保留している端末があるか
+ * サブウィンドウは wnoutrefresh() で curses の仮想画面に溜めておき、
+ * メインウィンドウの更新か入力待ちなどの前に、まとめて doupdate() で送る.
+ */
+static bool has_pending_update = false;
+
+/*
+ * 保留している描画を端末に送る
+ */
+static void flush_pending_update(void)
+{
+    if (!has_pending_update) {
+        return;
+    }
+
+    has_pending_update = false;
+    (void)doupdate();
+}
+
 /*
  * Handle a "special request"
  */
@@ -964,6 +984,7 @@ static errr game_term_xtra_gcu(int n, int v)
 
     /* Make a noise */
     case TERM_XTRA_NOISE:
+        flush_pending_update();
         return write(1, "\007", 1) != 1;
 
     /* Make a special sound */
@@ -971,21 +992,31 @@ static errr game_term_xtra_gcu(int n, int v)
         return game_term_xtra_gcu_sound(v);
 
     /* Flush the Curses buffer */
+    /* サブウィンドウは保留し、メインウィンドウの更新時にまとめて送る */
     case TERM_XTRA_FRESH:
-        (void)wrefresh(td->win);
+        (void)wnoutrefresh(td->win);
+        has_pending_update = true;
+        if (td == &data[0]) {
+            flush_pending_update();
+        }
+
         return 0;
 
     /* Change the cursor visibility */
     case TERM_XTRA_SHAPE:
+        flush_pending_update();
         curs_set(v);
         return 0;
 
     /* Suspend/Resume curses */
     case TERM_XTRA_ALIVE:
+        flush_pending_update();
         return game_term_xtra_gcu_alive(v);
 
     /* Process events */
+    /* 入力を待つ前に、保留している描画を送る */
     case TERM_XTRA_EVENT:
+        flush_pending_update();
         return game_term_xtra_gcu_event(v);
 
     /* Flush events */
@@ -997,6 +1028,7 @@ static errr game_term_xtra_gcu(int n, int v)
 
     /* Delay */
     case TERM_XTRA_DELAY:
+        flush_pending_update();
         usleep(1000 * v);
         return 0;
 
@@ -2451,6 +2451,7 @@ LRESULT PASCAL angband_window_procedure(HWND hWnd, UINT uMsg, WPARAM wParam, LPA
         signals_ignore_tstp();
         p_ptr->died_from = _("(緊急セーブ)", "(panic save)");
         (void)save_player(p_ptr, SaveType::CLOSE_GAME);
+        finish_movie_recording();
         quit(nullptr);
         return 0;
     }
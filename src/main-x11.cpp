@@ -108,9 +108,12 @@
 #include "util/int-char-converter.h"
 #include "util/string-processor.h"
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <span>
 #include <string>
+#include <unordered_map>
 
 /*
  * Available graphic modes
@@ -1016,7 +1019,8 @@ struct term_data {
     std::unique_ptr<infowin> win;
 #ifndef USE_XFT
     XImage *tiles;
-    XImage *TmpImage;
+    std::unordered_map<uint32_t, XImage *> composited_tiles; //!< 前景タイルを地形タイルに重ねた画像 (キーは両者の属性と文字)
+    XImage *strip; //!< 1回の描画で並べるタイルをまとめて転送するための作業用画像
 #endif
 };
 }
@@ -2056,64 +2060,136 @@ static errr game_term_text_x11(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR a, conc
 
 #ifndef USE_XFT
 /*
- * Draw some graphical characters.
+ * 重ねたタイルの保持数の上限. 超えたら全て捨てて作り直す.
  */
-static errr game_term_pict_x11(TERM_LEN x, TERM_LEN y, int n, const TERM_COLOR *ap, const char *cp, const TERM_COLOR *tap, const char *tcp)
+constexpr auto MAX_COMPOSITED_TILES = 4096;
+
+/*!
+ * @brief タイル画像と同じ形式の作業用画像を作る
+ * @param tiles タイル画像
+ * @param width 幅
+ * @param height 高さ
+ * @return 作った画像
+ */
+static XImage *create_tile_image(XImage *tiles, int width, int height)
 {
-    int i, x1, y1;
+    Display *dpy = Metadpy->dpy;
+    Visual *visual = DefaultVisual(dpy, DefaultScreen(dpy));
+    auto *image = XCreateImage(dpy, visual, tiles->depth, ZPixmap, 0, nullptr, width, height, 32, 0);
+    image->data = static_cast<char *>(malloc(image->bytes_per_line * height));
+    return image;
+}
 
-    TERM_COLOR a;
-    char c;
+/*!
+ * @brief 画像の矩形を別の画像に写す
+ * @details 画素の形式が同じなら行単位で複写し、異なる時だけ1画素ずつ変換する.
+ */
+static void copy_tile_image(XImage *dest, int dest_x, XImage *src, int src_x, int src_y, int width, int height)
+{
+    const auto bits = src->bits_per_pixel;
+    if ((bits == dest->bits_per_pixel) && (bits % 8 == 0) && (src->byte_order == dest->byte_order)) {
+        const auto bytes = bits / 8;
+        for (auto l = 0; l < height; l++) {
+            memcpy(dest->data + l * dest->bytes_per_line + dest_x * bytes, src->data + (src_y + l) * src->bytes_per_line + src_x * bytes, width * bytes);
+        }
 
-    TERM_COLOR ta;
-    char tc;
+        return;
+    }
 
-    int x2, y2;
-    int k, l;
+    for (auto l = 0; l < height; l++) {
+        for (auto k = 0; k < width; k++) {
+            XPutPixel(dest, dest_x + k, l, XGetPixel(src, src_x + k, src_y + l));
+        }
+    }
+}
 
-    unsigned long pixel, blank;
+/*!
+ * @brief 前景タイルの透過部分に地形タイルを重ねた画像を得る
+ * @details 重ねた結果はタイルの組ごとに保持し、2回目以降は画素単位の合成を行わない.
+ */
+static XImage *get_composited_tile(term_data *td, TERM_COLOR a, char c, TERM_COLOR ta, char tc)
+{
+    const auto key = (static_cast<uint32_t>(a & 0x7F) << 21) | (static_cast<uint32_t>(c & 0x7F) << 14) | (static_cast<uint32_t>(ta & 0x7F) << 7) | static_cast<uint32_t>(tc & 0x7F);
+    const auto it = td->composited_tiles.find(key);
+    if (it != td->composited_tiles.end()) {
+        return it->second;
+    }
 
-    term_data *td = (term_data *)(game_term->data);
+    if (td->composited_tiles.size() >= MAX_COMPOSITED_TILES) {
+        for (auto &[unused, image] : td->composited_tiles) {
+            XDestroyImage(image);
+        }
 
-    y *= Infofnt->hgt;
-    x *= Infofnt->wid;
-
-    y += Infowin->oy;
-    x += Infowin->ox;
-    for (i = 0; i < n; ++i, x += td->fnt->wid) {
-        a = *ap++;
-        c = *cp++;
-        x1 = (c & 0x7F) * td->fnt->twid;
-        y1 = (a & 0x7F) * td->fnt->hgt;
-        if (td->tiles->width < x1 + td->fnt->wid || td->tiles->height < y1 + td->fnt->hgt) {
-            XFillRectangle(Metadpy->dpy, td->win->win, clr[0]->gc, x, y, td->fnt->twid, td->fnt->hgt);
-            continue;
+        td->composited_tiles.clear();
+    }
+
+    const auto x1 = (c & 0x7F) * td->fnt->twid;
+    const auto y1 = (a & 0x7F) * td->fnt->hgt;
+    const auto x2 = (tc & 0x7F) * td->fnt->twid;
+    const auto y2 = (ta & 0x7F) * td->fnt->hgt;
+    auto *image = create_tile_image(td->tiles, td->fnt->twid, td->fnt->hgt);
+    const auto blank = XGetPixel(td->tiles, 0, td->fnt->hgt * 6);
+    for (auto k = 0; k < td->fnt->twid; k++) {
+        for (auto l = 0; l < td->fnt->hgt; l++) {
+            auto pixel = XGetPixel(td->tiles, x1 + k, y1 + l);
+            if (pixel == blank) {
+                pixel = XGetPixel(td->tiles, x2 + k, y2 + l);
+            }
+
+            XPutPixel(image, k, l, pixel);
         }
+    }
 
-        ta = *tap++;
-        tc = *tcp++;
+    td->composited_tiles.emplace(key, image);
+    return image;
+}
 
-        x2 = (tc & 0x7F) * td->fnt->twid;
-        y2 = (ta & 0x7F) * td->fnt->hgt;
+/*
+ * Draw some graphical characters.
+ * 並んだタイルを作業用画像に並べてから、1回の XPutImage() でまとめて転送する.
+ */
+static errr game_term_pict_x11(TERM_LEN x, TERM_LEN y, int n, const TERM_COLOR *ap, const char *cp, const TERM_COLOR *tap, const char *tcp)
+{
+    term_data *td = (term_data *)(game_term->data);
+    const auto twid = td->fnt->twid;
+    const auto hgt = td->fnt->hgt;
+    const auto strip_width = (n - 1) * td->fnt->wid + twid;
+    if ((td->strip == nullptr) || (td->strip->width < strip_width) || (td->strip->height != hgt)) {
+        if (td->strip != nullptr) {
+            XDestroyImage(td->strip);
+        }
 
-        if (((x1 == x2) && (y1 == y2)) || !(((byte)ta & 0x80) && ((byte)tc & 0x80)) || td->tiles->width < x2 + td->fnt->wid || td->tiles->height < y2 + td->fnt->hgt) {
-            XPutImage(Metadpy->dpy, td->win->win, clr[0]->gc, td->tiles, x1, y1, x, y, td->fnt->twid, td->fnt->hgt);
-        } else {
-            blank = XGetPixel(td->tiles, 0, td->fnt->hgt * 6);
-            for (k = 0; k < td->fnt->twid; k++) {
-                for (l = 0; l < td->fnt->hgt; l++) {
-                    if ((pixel = XGetPixel(td->tiles, x1 + k, y1 + l)) == blank) {
-                        pixel = XGetPixel(td->tiles, x2 + k, y2 + l);
-                    }
-
-                    XPutPixel(td->TmpImage, k, l, pixel);
+        td->strip = create_tile_image(td->tiles, std::max(strip_width, td->t.wid * td->fnt->wid + twid), hgt);
+    }
+
+    for (auto i = 0; i < n; ++i) {
+        const auto a = ap[i];
+        const auto c = cp[i];
+        const auto ta = tap[i];
+        const auto tc = tcp[i];
+        const auto dest_x = i * td->fnt->wid;
+        const auto x1 = (c & 0x7F) * twid;
+        const auto y1 = (a & 0x7F) * hgt;
+        if (td->tiles->width < x1 + td->fnt->wid || td->tiles->height < y1 + hgt) {
+            for (auto l = 0; l < hgt; l++) {
+                for (auto k = 0; k < twid; k++) {
+                    XPutPixel(td->strip, dest_x + k, l, clr[0]->fg);
                 }
             }
 
-            XPutImage(Metadpy->dpy, td->win->win, clr[0]->gc, td->TmpImage, 0, 0, x, y, td->fnt->twid, td->fnt->hgt);
+            continue;
+        }
+
+        const auto x2 = (tc & 0x7F) * twid;
+        const auto y2 = (ta & 0x7F) * hgt;
+        if (((x1 == x2) && (y1 == y2)) || !(((byte)ta & 0x80) && ((byte)tc & 0x80)) || td->tiles->width < x2 + td->fnt->wid || td->tiles->height < y2 + hgt) {
+            copy_tile_image(td->strip, dest_x, td->tiles, x1, y1, twid, hgt);
+        } else {
+            copy_tile_image(td->strip, dest_x, get_composited_tile(td, a, c, ta, tc), 0, 0, twid, hgt);
         }
     }
 
+    XPutImage(Metadpy->dpy, td->win->win, clr[0]->gc, td->strip, 0, 0, x * Infofnt->wid + Infowin->ox, y * Infofnt->hgt + Infowin->oy, strip_width, hgt);
     s_ptr->drawn = false;
     return 0;
 }
@@ -2454,8 +2530,6 @@ errr init_x11(int argc, char *argv[])
 #ifndef USE_XFT
     int pict_wid = 0;
     int pict_hgt = 0;
-
-    char *TmpData;
 #endif
 
     for (i = 1; i < argc; i++) {
@@ -2615,21 +2689,6 @@ errr init_x11(int argc, char *argv[])
             td->tiles = ResizeImage(dpy, tiles_raw, pict_wid, pict_hgt, td->fnt->twid, td->fnt->hgt);
         }
 
-        for (i = 0; i < num_term; i++) {
-            term_data *td = &data[i];
-            int ii, jj;
-            int depth = DefaultDepth(dpy, DefaultScreen(dpy));
-            Visual *visual = DefaultVisual(dpy, DefaultScreen(dpy));
-            int total;
-            ii = 1;
-            jj = (depth - 1) >> 2;
-            while (jj >>= 1) {
-                ii <<= 1;
-            }
-            total = td->fnt->twid * td->fnt->hgt * ii;
-            TmpData = (char *)malloc(total);
-            td->TmpImage = XCreateImage(dpy, visual, depth, ZPixmap, 0, TmpData, td->fnt->twid, td->fnt->hgt, 8, 0);
-        }
     }
 #endif /* ! USE_XFT */
     return 0;
@@ -28,8 +28,10 @@
 #include "view/display-scores.h"
 #include "wizard/spoiler-util.h"
 #include "wizard/wizard-spoiler.h"
+#include <algorithm>
 #include <filesystem>
 #include <string>
+#include <string_view>
 
 /*
  * Available graphic modes
@@ -180,6 +182,8 @@ static void display_usage(const char *program)
     puts("  -d<def>  Define a 'lib' dir sub-path");
     puts("  --output-spoilers");
     puts("           Output auto generated spoilers and exit");
+    puts("  --frame-budget=<msec>");
+    puts("           Redraw at most once per <msec> while resting or repeating (0: every turn)");
     puts("");
 
 #ifdef USE_X11
@@ -212,10 +216,16 @@ static void display_usage(const char *program)
  * @brief 2文字以上のコマンドライン引数 (オプション)を実行する
  * @param opt コマンドライン引数
  * @return Usageを表示する必要があるか否か
- * @details v3.0.0 Alpha21時点では、スポイラー出力モードの判定及び実行を行う
+ * @details スポイラー出力モードの判定及び実行と、連続行動中の描画間隔の指定を行う
  */
 static bool parse_long_opt(const char *opt)
 {
+    constexpr std::string_view frame_budget_opt = "frame-budget=";
+    if (std::string_view(opt + 2).starts_with(frame_budget_opt)) {
+        arg_frame_budget_msec = std::max(0, atoi(opt + 2 + frame_budget_opt.length()));
+        return false;
+    }
+
     if (strcmp(opt + 2, "output-spoilers") != 0) {
         return true;
     }
@@ -55,6 +55,13 @@ void init_other(PlayerType *player_ptr)
         list.assign(w_ptr->max_m_idx, {});
     }
 
+    for (auto &index : floor_ptr->mproc_index) {
+        index.assign(w_ptr->max_m_idx, -1);
+    }
+
+    floor_ptr->sleep_check_bits.assign((w_ptr->max_m_idx + 63) / 64, 0);
+    floor_ptr->sleep_check_ranges.assign(w_ptr->max_m_idx, 0);
+
     max_dlv.assign(dungeons_info.size(), {});
     floor_ptr->grid_array.assign(MAX_HGT, std::vector<Grid>(MAX_WID));
     init_gf_colors();
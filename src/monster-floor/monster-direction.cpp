@@ -5,6 +5,7 @@
  */
 
 #include "monster-floor/monster-direction.h"
+#include "effect/spells-effect-util.h"
 #include "floor/cave.h"
 #include "monster-floor/monster-sweep-grid.h"
 #include "monster-race/monster-race.h"
@@ -12,6 +13,7 @@
 #include "monster-race/race-flags2.h"
 #include "monster/monster-info.h"
 #include "monster/monster-processor-util.h"
+#include "monster/monster-spatial-index.h"
 #include "monster/monster-status.h"
 #include "pet/pet-util.h"
 #include "player/player-status-flags.h"
@@ -22,6 +24,7 @@
 #include "system/monster-race-info.h"
 #include "system/player-type-definition.h"
 #include "target/projection-path-calculator.h"
+#include <algorithm>
 
 /*!
  * @brief ペットが敵に接近するための方向を決定する
@@ -33,7 +36,6 @@
  */
 static bool decide_pet_approch_direction(PlayerType *player_ptr, MonsterEntity *m_ptr, MonsterEntity *t_ptr)
 {
-    auto *r_ptr = &m_ptr->get_monrace();
     if (!m_ptr->is_pet()) {
         return false;
     }
@@ -46,7 +48,7 @@ static bool decide_pet_approch_direction(PlayerType *player_ptr, MonsterEntity *
         return true;
     }
 
-    return r_ptr->aaf < t_ptr->cdis;
+    return m_ptr->get_monrace().aaf < t_ptr->cdis;
 }
 
 /*!
@@ -57,49 +59,48 @@ static bool decide_pet_approch_direction(PlayerType *player_ptr, MonsterEntity *
  * @param plus モンスターIDの増減 (1/2 の確率で+1、1/2の確率で-1)
  * @param y モンスターの移動方向Y
  * @param x モンスターの移動方向X
+ * @details 近い相手から順に調べ、最初に見つかった接近できる敵を選ぶ. 同じ距離の相手は start から plus ずつ巡回した順に調べる.
+ * 投射の届く相手しか選ばないため、壁を抜けられないモンスターは射程の外を調べない.
  */
 static void decide_enemy_approch_direction(PlayerType *player_ptr, MONSTER_IDX m_idx, int start, int plus, POSITION *y, POSITION *x)
 {
     auto *floor_ptr = player_ptr->current_floor_ptr;
     auto *m_ptr = &floor_ptr->m_list[m_idx];
     auto *r_ptr = &m_ptr->get_monrace();
-    for (int i = start; ((i < start + floor_ptr->m_max) && (i > start - floor_ptr->m_max)); i += plus) {
-        MONSTER_IDX dummy = (i % floor_ptr->m_max);
-        if (dummy == 0) {
-            continue;
-        }
-
-        MONSTER_IDX t_idx = dummy;
+    const auto can_pass_wall = r_ptr->feature_flags.has(MonsterFeatureType::PASS_WALL) && ((m_idx != player_ptr->riding) || has_pass_wall(player_ptr));
+    const auto can_kill_wall = r_ptr->feature_flags.has(MonsterFeatureType::KILL_WALL) && (m_idx != player_ptr->riding);
+    const auto is_limited = !can_pass_wall && !can_kill_wall && (project_length == 0);
+    const auto range = is_limited ? AngbandSystem::get_instance().get_max_range() : std::max(floor_ptr->height, floor_ptr->width);
+    const auto first = start % floor_ptr->m_max;
+    const auto get_order = [floor_ptr, first, plus](MONSTER_IDX t_idx) {
+        return (plus > 0) ? (t_idx - first + floor_ptr->m_max) % floor_ptr->m_max : (first - t_idx + floor_ptr->m_max) % floor_ptr->m_max;
+    };
+    const auto accept = [player_ptr, floor_ptr, m_ptr, can_pass_wall, can_kill_wall](MONSTER_IDX t_idx) {
         auto *t_ptr = &floor_ptr->m_list[t_idx];
         if (t_ptr == m_ptr) {
-            continue;
-        }
-        if (!t_ptr->is_valid()) {
-            continue;
+            return false;
         }
         if (decide_pet_approch_direction(player_ptr, m_ptr, t_ptr)) {
-            continue;
+            return false;
         }
         if (!m_ptr->is_hostile_to_melee(*t_ptr)) {
-            continue;
+            return false;
         }
 
-        const auto can_pass_wall = r_ptr->feature_flags.has(MonsterFeatureType::PASS_WALL) && ((m_idx != player_ptr->riding) || has_pass_wall(player_ptr));
-        const auto can_kill_wall = r_ptr->feature_flags.has(MonsterFeatureType::KILL_WALL) && (m_idx != player_ptr->riding);
         if (can_pass_wall || can_kill_wall) {
-            if (!in_disintegration_range(floor_ptr, m_ptr->fy, m_ptr->fx, t_ptr->fy, t_ptr->fx)) {
-                continue;
-            }
-        } else {
-            if (!projectable(player_ptr, m_ptr->fy, m_ptr->fx, t_ptr->fy, t_ptr->fx)) {
-                continue;
-            }
+            return in_disintegration_range(floor_ptr, m_ptr->fy, m_ptr->fx, t_ptr->fy, t_ptr->fx);
         }
 
-        *y = t_ptr->fy;
-        *x = t_ptr->fx;
+        return projectable(player_ptr, m_ptr->fy, m_ptr->fx, t_ptr->fy, t_ptr->fx);
+    };
+
+    const auto t_idx = MonsterSpatialIndex::get_instance().find_nearest(*floor_ptr, { m_ptr->fy, m_ptr->fx }, range, get_order, accept);
+    if (t_idx == 0) {
         return;
     }
+
+    *y = floor_ptr->m_list[t_idx].fy;
+    *x = floor_ptr->m_list[t_idx].fx;
 }
 
 /*!
@@ -9,4 +9,4 @@ struct monster_lite_type {
 };
 
 class MonsterEntity;
-monster_lite_type *initialize_monster_lite_type(BIT_FLAGS grid_info, monster_lite_type *ml_ptr, MonsterEntity *m_ptr);
+monster_lite_type *initialize_monster_lite_type(BIT_FLAGS grid_info, monster_lite_type *ml_ptr, const MonsterEntity *m_ptr);
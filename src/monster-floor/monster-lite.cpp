@@ -1,12 +1,14 @@
 #include "monster-floor/monster-lite.h"
 #include "dungeon/dungeon-flag-types.h"
 #include "floor/cave.h"
+#include "floor/line-of-sight-cache.h"
 #include "grid/feature-flag-types.h"
 #include "grid/grid.h"
 #include "monster-floor/monster-lite-util.h"
 #include "monster-race/monster-race.h"
 #include "monster-race/race-brightness-flags.h"
 #include "monster-race/race-flags7.h"
+#include "monster/monster-spatial-index.h"
 #include "monster/monster-status.h"
 #include "player-base/player-class.h"
 #include "player-info/ninja-data-type.h"
@@ -22,12 +24,13 @@
 #include "util/point-2d.h"
 #include "view/display-messages.h"
 #include "world/world.h"
+#include <utility>
 #include <vector>
 
 /*!
- * @brief モンスターによる光量状態更新 / Add a square to the changes array
+ * @brief モンスターの光源が届くマスを記録する / Add a square to the changes array
  * @param player_ptr プレイヤーへの参照ポインタ
- * @param points 座標たちを記録する配列
+ * @param points 光源が届く座標たちを記録する配列
  * @param y Y座標
  * @param x X座標
  */
@@ -38,7 +41,7 @@ static void update_monster_lite(
     int dpf, d;
     POSITION midpoint;
     g_ptr = &player_ptr->current_floor_ptr->grid_array[y][x];
-    if ((g_ptr->info & (CAVE_MNLT | CAVE_VIEW)) != CAVE_VIEW) {
+    if (!(g_ptr->info & CAVE_VIEW)) {
         return;
     }
 
@@ -78,17 +81,12 @@ static void update_monster_lite(
         }
     }
 
-    if (!(g_ptr->info & CAVE_MNDK)) {
-        points.emplace_back(y, x);
-    } else {
-        g_ptr->info &= ~(CAVE_MNDK);
-    }
-
-    g_ptr->info |= CAVE_MNLT;
+    points.emplace_back(y, x);
 }
 
-/*
- * Add a square to the changes array
+/*!
+ * @brief モンスターの暗源が届くマスを記録する / Add a square to the changes array
+ * @details 他の光源で照らされているマスからは後で除く.
  */
 static void update_monster_dark(
     PlayerType *const player_ptr, std::vector<Pos2D> &points, const POSITION y, const POSITION x, const monster_lite_type *const ml_ptr)
@@ -96,7 +94,7 @@ static void update_monster_dark(
     Grid *g_ptr;
     int midpoint, dpf, d;
     g_ptr = &player_ptr->current_floor_ptr->grid_array[y][x];
-    if ((g_ptr->info & (CAVE_LITE | CAVE_MNLT | CAVE_MNDK | CAVE_VIEW)) != CAVE_VIEW) {
+    if (!(g_ptr->info & CAVE_VIEW)) {
         return;
     }
 
@@ -137,211 +135,385 @@ static void update_monster_dark(
     }
 
     points.emplace_back(y, x);
-    g_ptr->info |= CAVE_MNDK;
 }
 
 /*!
- * @brief Update squares illuminated or darkened by monsters.
- * The CAVE_TEMP and CAVE_XTRA flag are used to store the state during the
- * updating.  Only squares in view of the player, whos state
- * changes are drawn via lite_spot().
- * @todo player-status からのみ呼ばれている。しかしあちらは行数が酷いので要調整
+ * @brief モンスターの光源・暗源の半径を求める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param monster モンスターへの参照
+ * @return 光源なら正、暗源なら負の半径. 光も闇も発していなければ0
  */
-void update_mon_lite(PlayerType *player_ptr)
+static int get_monster_lite_radius(PlayerType *player_ptr, const MonsterEntity &monster)
 {
-    // 座標たちを記録する配列。
-    std::vector<Pos2D> points;
+    const auto *floor_ptr = player_ptr->current_floor_ptr;
+    const auto &dungeon = floor_ptr->get_dungeon_definition();
+    const auto &monrace = monster.get_monrace();
+    auto rad = 0;
+    if (monrace.brightness_flags.has_any_of({ MonsterBrightnessType::HAS_LITE_1, MonsterBrightnessType::SELF_LITE_1 })) {
+        rad++;
+    }
 
-    void (*add_mon_lite)(PlayerType *, std::vector<Pos2D> &, const POSITION, const POSITION, const monster_lite_type *);
+    if (monrace.brightness_flags.has_any_of({ MonsterBrightnessType::HAS_LITE_2, MonsterBrightnessType::SELF_LITE_2 })) {
+        rad += 2;
+    }
+
+    if (monrace.brightness_flags.has_any_of({ MonsterBrightnessType::HAS_DARK_1, MonsterBrightnessType::SELF_DARK_1 })) {
+        rad--;
+    }
+
+    if (monrace.brightness_flags.has_any_of({ MonsterBrightnessType::HAS_DARK_2, MonsterBrightnessType::SELF_DARK_2 })) {
+        rad -= 2;
+    }
+
+    if (rad > 0) {
+        auto should_lite = monrace.brightness_flags.has_none_of({ MonsterBrightnessType::SELF_LITE_1, MonsterBrightnessType::SELF_LITE_2 });
+        should_lite &= (monster.is_asleep() || (!floor_ptr->dun_level && w_ptr->is_daytime()) || AngbandSystem::get_instance().is_phase_out());
+        if (should_lite) {
+            return 0;
+        }
+
+        return dungeon.flags.has(DungeonFeatureType::DARKNESS) ? 1 : rad;
+    }
+
+    if (rad < 0) {
+        if (monrace.brightness_flags.has_none_of({ MonsterBrightnessType::SELF_DARK_1, MonsterBrightnessType::SELF_DARK_2 }) && (monster.is_asleep() || (!floor_ptr->dun_level && !w_ptr->is_daytime()))) {
+            return 0;
+        }
+    }
+
+    return rad;
+}
+
+/*!
+ * @brief モンスター1体の光源・暗源が届くマスを集める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param grids 届くマスを記録する配列
+ * @param monster モンスターへの参照
+ * @param signed_rad get_monster_lite_radius() で求めた半径
+ * @details 結果はモンスターとプレイヤーの位置、視界、地形だけで決まる.
+ */
+static void collect_monster_lite_grids(PlayerType *player_ptr, std::vector<Pos2D> &grids, const MonsterEntity &monster, int signed_rad)
+{
     auto *floor_ptr = player_ptr->current_floor_ptr;
-    const auto &dungeon = floor_ptr->get_dungeon_definition();
-    auto dis_lim = (dungeon.flags.has(DungeonFeatureType::DARKNESS) && !player_ptr->see_nocto) ? (MAX_PLAYER_SIGHT / 2 + 1) : (MAX_PLAYER_SIGHT + 3);
-    for (int i = 0; i < floor_ptr->mon_lite_n; i++) {
-        Grid *g_ptr;
-        g_ptr = &floor_ptr->grid_array[floor_ptr->mon_lite_y[i]][floor_ptr->mon_lite_x[i]];
-        g_ptr->info |= (g_ptr->info & CAVE_MNLT) ? CAVE_TEMP : CAVE_XTRA;
-        g_ptr->info &= ~(CAVE_MNLT | CAVE_MNDK);
+    void (*add_mon_lite)(PlayerType *, std::vector<Pos2D> &, const POSITION, const POSITION, const monster_lite_type *);
+    TerrainCharacteristics f_flag;
+    int rad;
+    if (signed_rad > 0) {
+        add_mon_lite = update_monster_lite;
+        f_flag = TerrainCharacteristics::LOS;
+        rad = signed_rad;
+    } else {
+        add_mon_lite = update_monster_dark;
+        f_flag = TerrainCharacteristics::PROJECT;
+        rad = -signed_rad;
     }
 
-    if (!w_ptr->timewalk_m_idx) {
-        MonsterEntity *m_ptr;
-        MonsterRaceInfo *r_ptr;
-        for (int i = 1; i < floor_ptr->m_max; i++) {
-            m_ptr = &floor_ptr->m_list[i];
-            r_ptr = &m_ptr->get_monrace();
-            if (!m_ptr->is_valid() || (m_ptr->cdis > dis_lim)) {
-                continue;
-            }
+    monster_lite_type tmp_ml;
+    monster_lite_type *ml_ptr = initialize_monster_lite_type(floor_ptr->grid_array[monster.fy][monster.fx].info, &tmp_ml, &monster);
+    add_mon_lite(player_ptr, grids, ml_ptr->mon_fy, ml_ptr->mon_fx, ml_ptr);
+    add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 1, ml_ptr->mon_fx, ml_ptr);
+    add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 1, ml_ptr->mon_fx, ml_ptr);
+    add_mon_lite(player_ptr, grids, ml_ptr->mon_fy, ml_ptr->mon_fx + 1, ml_ptr);
+    add_mon_lite(player_ptr, grids, ml_ptr->mon_fy, ml_ptr->mon_fx - 1, ml_ptr);
+    add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 1, ml_ptr->mon_fx + 1, ml_ptr);
+    add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 1, ml_ptr->mon_fx - 1, ml_ptr);
+    add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 1, ml_ptr->mon_fx + 1, ml_ptr);
+    add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 1, ml_ptr->mon_fx - 1, ml_ptr);
+    if (rad < 2) {
+        return;
+    }
 
-            int rad = 0;
-            if (r_ptr->brightness_flags.has_any_of({ MonsterBrightnessType::HAS_LITE_1, MonsterBrightnessType::SELF_LITE_1 })) {
-                rad++;
-            }
+    Grid *g_ptr;
+    if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy + 1, ml_ptr->mon_fx, f_flag)) {
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 2, ml_ptr->mon_fx + 1, ml_ptr);
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 2, ml_ptr->mon_fx, ml_ptr);
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 2, ml_ptr->mon_fx - 1, ml_ptr);
+        g_ptr = &floor_ptr->grid_array[ml_ptr->mon_fy + 2][ml_ptr->mon_fx];
+        if ((rad == 3) && g_ptr->cave_has_flag(f_flag)) {
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 3, ml_ptr->mon_fx + 1, ml_ptr);
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 3, ml_ptr->mon_fx, ml_ptr);
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 3, ml_ptr->mon_fx - 1, ml_ptr);
+        }
+    }
 
-            if (r_ptr->brightness_flags.has_any_of({ MonsterBrightnessType::HAS_LITE_2, MonsterBrightnessType::SELF_LITE_2 })) {
-                rad += 2;
-            }
+    if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy - 1, ml_ptr->mon_fx, f_flag)) {
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 2, ml_ptr->mon_fx + 1, ml_ptr);
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 2, ml_ptr->mon_fx, ml_ptr);
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 2, ml_ptr->mon_fx - 1, ml_ptr);
+        g_ptr = &floor_ptr->grid_array[ml_ptr->mon_fy - 2][ml_ptr->mon_fx];
+        if ((rad == 3) && g_ptr->cave_has_flag(f_flag)) {
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 3, ml_ptr->mon_fx + 1, ml_ptr);
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 3, ml_ptr->mon_fx, ml_ptr);
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 3, ml_ptr->mon_fx - 1, ml_ptr);
+        }
+    }
 
-            if (r_ptr->brightness_flags.has_any_of({ MonsterBrightnessType::HAS_DARK_1, MonsterBrightnessType::SELF_DARK_1 })) {
-                rad--;
-            }
+    if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy, ml_ptr->mon_fx + 1, f_flag)) {
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 1, ml_ptr->mon_fx + 2, ml_ptr);
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy, ml_ptr->mon_fx + 2, ml_ptr);
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 1, ml_ptr->mon_fx + 2, ml_ptr);
+        g_ptr = &floor_ptr->grid_array[ml_ptr->mon_fy][ml_ptr->mon_fx + 2];
+        if ((rad == 3) && g_ptr->cave_has_flag(f_flag)) {
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 1, ml_ptr->mon_fx + 3, ml_ptr);
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy, ml_ptr->mon_fx + 3, ml_ptr);
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 1, ml_ptr->mon_fx + 3, ml_ptr);
+        }
+    }
 
-            if (r_ptr->brightness_flags.has_any_of({ MonsterBrightnessType::HAS_DARK_2, MonsterBrightnessType::SELF_DARK_2 })) {
-                rad -= 2;
-            }
+    if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy, ml_ptr->mon_fx - 1, f_flag)) {
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 1, ml_ptr->mon_fx - 2, ml_ptr);
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy, ml_ptr->mon_fx - 2, ml_ptr);
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 1, ml_ptr->mon_fx - 2, ml_ptr);
+        g_ptr = &floor_ptr->grid_array[ml_ptr->mon_fy][ml_ptr->mon_fx - 2];
+        if ((rad == 3) && g_ptr->cave_has_flag(f_flag)) {
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 1, ml_ptr->mon_fx - 3, ml_ptr);
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy, ml_ptr->mon_fx - 3, ml_ptr);
+            add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 1, ml_ptr->mon_fx - 3, ml_ptr);
+        }
+    }
 
-            if (!rad) {
-                continue;
-            }
+    if (rad != 3) {
+        return;
+    }
 
-            TerrainCharacteristics f_flag;
-            if (rad > 0) {
-                auto should_lite = r_ptr->brightness_flags.has_none_of({ MonsterBrightnessType::SELF_LITE_1, MonsterBrightnessType::SELF_LITE_2 });
-                should_lite &= (m_ptr->is_asleep() || (!floor_ptr->dun_level && w_ptr->is_daytime()) || AngbandSystem::get_instance().is_phase_out());
-                if (should_lite) {
-                    continue;
-                }
+    if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy + 1, ml_ptr->mon_fx + 1, f_flag)) {
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 2, ml_ptr->mon_fx + 2, ml_ptr);
+    }
 
-                if (dungeon.flags.has(DungeonFeatureType::DARKNESS)) {
-                    rad = 1;
-                }
+    if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy + 1, ml_ptr->mon_fx - 1, f_flag)) {
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy + 2, ml_ptr->mon_fx - 2, ml_ptr);
+    }
 
-                add_mon_lite = update_monster_lite;
-                f_flag = TerrainCharacteristics::LOS;
-            } else {
-                if (r_ptr->brightness_flags.has_none_of({ MonsterBrightnessType::SELF_DARK_1, MonsterBrightnessType::SELF_DARK_2 }) && (m_ptr->is_asleep() || (!floor_ptr->dun_level && !w_ptr->is_daytime()))) {
-                    continue;
-                }
+    if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy - 1, ml_ptr->mon_fx + 1, f_flag)) {
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 2, ml_ptr->mon_fx + 2, ml_ptr);
+    }
 
-                add_mon_lite = update_monster_dark;
-                f_flag = TerrainCharacteristics::PROJECT;
-                rad = -rad;
-            }
+    if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy - 1, ml_ptr->mon_fx - 1, f_flag)) {
+        add_mon_lite(player_ptr, grids, ml_ptr->mon_fy - 2, ml_ptr->mon_fx - 2, ml_ptr);
+    }
+}
 
-            monster_lite_type tmp_ml;
-            monster_lite_type *ml_ptr = initialize_monster_lite_type(floor_ptr->grid_array[m_ptr->fy][m_ptr->fx].info, &tmp_ml, m_ptr);
-            add_mon_lite(player_ptr, points, ml_ptr->mon_fy, ml_ptr->mon_fx, ml_ptr);
-            add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 1, ml_ptr->mon_fx, ml_ptr);
-            add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 1, ml_ptr->mon_fx, ml_ptr);
-            add_mon_lite(player_ptr, points, ml_ptr->mon_fy, ml_ptr->mon_fx + 1, ml_ptr);
-            add_mon_lite(player_ptr, points, ml_ptr->mon_fy, ml_ptr->mon_fx - 1, ml_ptr);
-            add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 1, ml_ptr->mon_fx + 1, ml_ptr);
-            add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 1, ml_ptr->mon_fx - 1, ml_ptr);
-            add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 1, ml_ptr->mon_fx + 1, ml_ptr);
-            add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 1, ml_ptr->mon_fx - 1, ml_ptr);
-            if (rad < 2) {
-                continue;
-            }
+namespace {
+/*!
+ * @brief モンスター1体分の光源・暗源が届くマスの記録
+ */
+struct monster_lite_footprint {
+    bool is_active = false;
+    uint32_t generation = 0; //!< 最後に有効と確認した更新の通し番号
+    Pos2D pos{ 0, 0 };
+    int rad = 0; //!< 光源なら正、暗源なら負の半径
+    std::vector<Pos2D> grids{};
+};
 
-            Grid *g_ptr;
-            if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy + 1, ml_ptr->mon_fx, f_flag)) {
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 2, ml_ptr->mon_fx + 1, ml_ptr);
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 2, ml_ptr->mon_fx, ml_ptr);
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 2, ml_ptr->mon_fx - 1, ml_ptr);
-                g_ptr = &floor_ptr->grid_array[ml_ptr->mon_fy + 2][ml_ptr->mon_fx];
-                if ((rad == 3) && g_ptr->cave_has_flag(f_flag)) {
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 3, ml_ptr->mon_fx + 1, ml_ptr);
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 3, ml_ptr->mon_fx, ml_ptr);
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 3, ml_ptr->mon_fx - 1, ml_ptr);
-                }
-            }
+/*!
+ * @brief モンスターの光源・暗源の差分更新に使う状態
+ * @details
+ * 各マスに届いている光源・暗源の数を数えておき、移動・睡眠・死亡などで光源が変わったモンスターの分だけ数え直す.
+ * 届くマスはプレイヤーの位置、視界、地形にも依存するため、それらが変わった時は全モンスター分を数え直す.
+ */
+struct monster_lite_cache {
+    const FloorType *floor_ptr = nullptr;
+    Pos2D player_pos{ 0, 0 };
+    uint32_t view_version = 0;
+    uint32_t terrain_version = 0;
+    int height = 0;
+    int width = 0;
+    bool is_valid = false;
+    uint32_t generation = 0;
+    std::vector<monster_lite_footprint> footprints{}; //!< モンスターIDごとの記録
+    std::vector<MONSTER_IDX> active_m_idxs{}; //!< 記録が有効なモンスターID
+    std::vector<uint16_t> lite_counts{}; //!< マスごとの届いている光源の数
+    std::vector<uint16_t> dark_counts{}; //!< マスごとの届いている暗源の数
+    std::vector<int> list_indices{}; //!< マスごとの mon_lite_y/x 上の位置 (無ければ-1)
+};
+
+monster_lite_cache cache;
+}
 
-            if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy - 1, ml_ptr->mon_fx, f_flag)) {
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 2, ml_ptr->mon_fx + 1, ml_ptr);
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 2, ml_ptr->mon_fx, ml_ptr);
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 2, ml_ptr->mon_fx - 1, ml_ptr);
-                g_ptr = &floor_ptr->grid_array[ml_ptr->mon_fy - 2][ml_ptr->mon_fx];
-                if ((rad == 3) && g_ptr->cave_has_flag(f_flag)) {
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 3, ml_ptr->mon_fx + 1, ml_ptr);
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 3, ml_ptr->mon_fx, ml_ptr);
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 3, ml_ptr->mon_fx - 1, ml_ptr);
-                }
-            }
+/*!
+ * @brief 差分更新の前提が崩れていれば記録を作り直す
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param touched 状態を確認し直すマスを記録する配列
+ */
+static void prepare_monster_lite_cache(PlayerType *player_ptr, std::vector<Pos2D> &touched)
+{
+    const auto *floor_ptr = player_ptr->current_floor_ptr;
+    const auto p_pos = player_ptr->get_position();
+    const auto terrain_version = LineOfSightCache::get_instance().get_terrain_version();
+    if (cache.is_valid && (cache.floor_ptr == floor_ptr) && (cache.player_pos == p_pos) && (cache.view_version == floor_ptr->view_version) && (cache.terrain_version == terrain_version) && (cache.height == floor_ptr->height) && (cache.width == floor_ptr->width)) {
+        return;
+    }
 
-            if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy, ml_ptr->mon_fx + 1, f_flag)) {
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 1, ml_ptr->mon_fx + 2, ml_ptr);
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy, ml_ptr->mon_fx + 2, ml_ptr);
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 1, ml_ptr->mon_fx + 2, ml_ptr);
-                g_ptr = &floor_ptr->grid_array[ml_ptr->mon_fy][ml_ptr->mon_fx + 2];
-                if ((rad == 3) && g_ptr->cave_has_flag(f_flag)) {
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 1, ml_ptr->mon_fx + 3, ml_ptr);
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy, ml_ptr->mon_fx + 3, ml_ptr);
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 1, ml_ptr->mon_fx + 3, ml_ptr);
-                }
-            }
+    cache.floor_ptr = floor_ptr;
+    cache.player_pos = p_pos;
+    cache.view_version = floor_ptr->view_version;
+    cache.terrain_version = terrain_version;
+    cache.height = floor_ptr->height;
+    cache.width = floor_ptr->width;
+    cache.is_valid = true;
+    for (const auto m_idx : cache.active_m_idxs) {
+        auto &footprint = cache.footprints[m_idx];
+        footprint.is_active = false;
+        footprint.grids.clear();
+    }
 
-            if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy, ml_ptr->mon_fx - 1, f_flag)) {
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 1, ml_ptr->mon_fx - 2, ml_ptr);
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy, ml_ptr->mon_fx - 2, ml_ptr);
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 1, ml_ptr->mon_fx - 2, ml_ptr);
-                g_ptr = &floor_ptr->grid_array[ml_ptr->mon_fy][ml_ptr->mon_fx - 2];
-                if ((rad == 3) && g_ptr->cave_has_flag(f_flag)) {
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 1, ml_ptr->mon_fx - 3, ml_ptr);
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy, ml_ptr->mon_fx - 3, ml_ptr);
-                    add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 1, ml_ptr->mon_fx - 3, ml_ptr);
-                }
-            }
+    cache.active_m_idxs.clear();
+    const auto size = cache.height * cache.width;
+    cache.lite_counts.assign(size, 0);
+    cache.dark_counts.assign(size, 0);
+    cache.list_indices.assign(size, -1);
+    for (auto i = 0; i < floor_ptr->mon_lite_n; i++) {
+        const Pos2D pos(floor_ptr->mon_lite_y[i], floor_ptr->mon_lite_x[i]);
+        cache.list_indices[pos.y * cache.width + pos.x] = i;
+        touched.push_back(pos);
+    }
+}
 
-            if (rad != 3) {
-                continue;
-            }
+/*!
+ * @brief モンスター1体分の光源・暗源を数え上げに加える、または取り除く
+ * @param footprint モンスターの記録
+ * @param touched 状態を確認し直すマスを記録する配列
+ * @param is_adding 加えるならtrue、取り除くならfalse
+ */
+static void count_monster_lite(const monster_lite_footprint &footprint, std::vector<Pos2D> &touched, bool is_adding)
+{
+    auto &counts = (footprint.rad > 0) ? cache.lite_counts : cache.dark_counts;
+    for (const auto &pos : footprint.grids) {
+        auto &count = counts[pos.y * cache.width + pos.x];
+        count = is_adding ? count + 1 : count - 1;
+        touched.push_back(pos);
+    }
+}
 
-            if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy + 1, ml_ptr->mon_fx + 1, f_flag)) {
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 2, ml_ptr->mon_fx + 2, ml_ptr);
-            }
+/*!
+ * @brief マスの光量状態を数え上げに合わせ、変化したマスを再描画する
+ * @param floor_ptr 現在フロアへの参照ポインタ
+ * @param pos 対象のマス
+ * @details 光源が届くマスは明るく、光源が届かず暗源が届くマスはプレイヤーの光源で照らされていなければ暗くなる.
+ */
+static void apply_monster_lite(FloorType *floor_ptr, const Pos2D &pos)
+{
+    const auto index = pos.y * cache.width + pos.x;
+    auto &grid = floor_ptr->get_grid(pos);
+    BIT_FLAGS state = 0;
+    if (cache.lite_counts[index] > 0) {
+        state = CAVE_MNLT;
+    } else if ((cache.dark_counts[index] > 0) && !(grid.info & CAVE_LITE)) {
+        state = CAVE_MNDK;
+    }
 
-            if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy + 1, ml_ptr->mon_fx - 1, f_flag)) {
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy + 2, ml_ptr->mon_fx - 2, ml_ptr);
-            }
+    if ((grid.info & (CAVE_MNLT | CAVE_MNDK)) != state) {
+        grid.info = (grid.info & ~(CAVE_MNLT | CAVE_MNDK)) | state;
+        if (grid.info & CAVE_VIEW) {
+            cave_note_and_redraw_later(floor_ptr, pos.y, pos.x);
+        }
+    }
+
+    auto &list_index = cache.list_indices[index];
+    if ((state != 0) && (list_index < 0) && (floor_ptr->mon_lite_n < MON_LITE_MAX)) {
+        list_index = floor_ptr->mon_lite_n++;
+        floor_ptr->mon_lite_y[list_index] = pos.y;
+        floor_ptr->mon_lite_x[list_index] = pos.x;
+        return;
+    }
+
+    if ((state == 0) && (list_index >= 0)) {
+        const auto last = --floor_ptr->mon_lite_n;
+        const auto last_y = floor_ptr->mon_lite_y[last];
+        const auto last_x = floor_ptr->mon_lite_x[last];
+        floor_ptr->mon_lite_y[list_index] = last_y;
+        floor_ptr->mon_lite_x[list_index] = last_x;
+        cache.list_indices[last_y * cache.width + last_x] = list_index;
+        list_index = -1;
+    }
+}
 
-            if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy - 1, ml_ptr->mon_fx + 1, f_flag)) {
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 2, ml_ptr->mon_fx + 2, ml_ptr);
+/*!
+ * @brief Update squares illuminated or darkened by monsters.
+ * @details
+ * 光源・暗源が変わったモンスターの分だけ各マスの数え上げを更新し、数が変わったマスの光量状態を決め直す.
+ * 暗源の効果はプレイヤーの光源 (CAVE_LITE) にも左右されるため、暗源が届くマスは毎回決め直す.
+ * Only squares in view of the player, whos state changes are drawn via lite_spot().
+ * @todo player-status からのみ呼ばれている。しかしあちらは行数が酷いので要調整
+ */
+void update_mon_lite(PlayerType *player_ptr)
+{
+    // 状態を確認し直す座標たちと、今回光源・暗源を持つモンスターたち。毎回の確保を避けるため使い回す.
+    static std::vector<Pos2D> touched;
+    static std::vector<std::pair<MONSTER_IDX, int>> lite_monsters;
+    touched.clear();
+    lite_monsters.clear();
+
+    auto *floor_ptr = player_ptr->current_floor_ptr;
+    const auto &dungeon = floor_ptr->get_dungeon_definition();
+    auto dis_lim = (dungeon.flags.has(DungeonFeatureType::DARKNESS) && !player_ptr->see_nocto) ? (MAX_PLAYER_SIGHT / 2 + 1) : (MAX_PLAYER_SIGHT + 3);
+    prepare_monster_lite_cache(player_ptr, touched);
+    if (!w_ptr->timewalk_m_idx) {
+        const Pos2D p_pos(player_ptr->y, player_ptr->x);
+        for (const auto i : MonsterSpatialIndex::get_instance().collect_in_rect(*floor_ptr, { p_pos.y - dis_lim, p_pos.x - dis_lim }, { p_pos.y + dis_lim, p_pos.x + dis_lim })) {
+            const auto &monster = floor_ptr->m_list[i];
+            if (monster.cdis > dis_lim) {
+                continue;
             }
 
-            if (cave_has_flag_bold(player_ptr->current_floor_ptr, ml_ptr->mon_fy - 1, ml_ptr->mon_fx - 1, f_flag)) {
-                add_mon_lite(player_ptr, points, ml_ptr->mon_fy - 2, ml_ptr->mon_fx - 2, ml_ptr);
+            const auto rad = get_monster_lite_radius(player_ptr, monster);
+            if (rad != 0) {
+                lite_monsters.emplace_back(i, rad);
             }
         }
     }
 
-    const auto end_temp = size(points);
-    for (int i = 0; i < floor_ptr->mon_lite_n; i++) {
-        POSITION fx = floor_ptr->mon_lite_x[i];
-        POSITION fy = floor_ptr->mon_lite_y[i];
-        Grid *g_ptr;
-        g_ptr = &floor_ptr->grid_array[fy][fx];
-        if (g_ptr->info & CAVE_TEMP) {
-            if ((g_ptr->info & (CAVE_VIEW | CAVE_MNLT)) == CAVE_VIEW) {
-                cave_note_and_redraw_later(floor_ptr, fy, fx);
-            }
-        } else if ((g_ptr->info & (CAVE_VIEW | CAVE_MNDK)) == CAVE_VIEW) {
-            cave_note_and_redraw_later(floor_ptr, fy, fx);
+    const auto generation = ++cache.generation;
+    for (const auto &[m_idx, rad] : lite_monsters) {
+        if (cache.footprints.size() <= static_cast<size_t>(m_idx)) {
+            cache.footprints.resize(m_idx + 1);
         }
 
-        points.emplace_back(fy, fx);
+        auto &footprint = cache.footprints[m_idx];
+        if (footprint.is_active && (footprint.pos == Pos2D(floor_ptr->m_list[m_idx].fy, floor_ptr->m_list[m_idx].fx)) && (footprint.rad == rad)) {
+            footprint.generation = generation;
+        }
     }
 
-    floor_ptr->mon_lite_n = 0;
-    for (size_t i = 0; i < end_temp; i++) {
-        const auto &[fy, fx] = points[i];
+    for (const auto m_idx : cache.active_m_idxs) {
+        auto &footprint = cache.footprints[m_idx];
+        if (footprint.generation != generation) {
+            count_monster_lite(footprint, touched, false);
+            footprint.is_active = false;
+            footprint.grids.clear();
+        }
+    }
 
-        Grid *const g_ptr = &floor_ptr->grid_array[fy][fx];
-        if (g_ptr->info & CAVE_MNLT) {
-            if ((g_ptr->info & (CAVE_VIEW | CAVE_TEMP)) == CAVE_VIEW) {
-                cave_note_and_redraw_later(floor_ptr, fy, fx);
-            }
-        } else if ((g_ptr->info & (CAVE_VIEW | CAVE_XTRA)) == CAVE_VIEW) {
-            cave_note_and_redraw_later(floor_ptr, fy, fx);
+    cache.active_m_idxs.clear();
+    for (const auto &[m_idx, rad] : lite_monsters) {
+        auto &footprint = cache.footprints[m_idx];
+        cache.active_m_idxs.push_back(m_idx);
+        if (footprint.is_active) {
+            continue;
         }
 
-        floor_ptr->mon_lite_x[floor_ptr->mon_lite_n] = fx;
-        floor_ptr->mon_lite_y[floor_ptr->mon_lite_n] = fy;
-        floor_ptr->mon_lite_n++;
+        const auto &monster = floor_ptr->m_list[m_idx];
+        footprint.is_active = true;
+        footprint.generation = generation;
+        footprint.pos = { monster.fy, monster.fx };
+        footprint.rad = rad;
+        collect_monster_lite_grids(player_ptr, footprint.grids, monster, rad);
+        count_monster_lite(footprint, touched, true);
+    }
+
+    for (const auto &pos : touched) {
+        apply_monster_lite(floor_ptr, pos);
     }
 
-    for (size_t i = end_temp; i < size(points); i++) {
-        const auto &[y, x] = points[i];
-        floor_ptr->grid_array[y][x].info &= ~(CAVE_TEMP | CAVE_XTRA);
+    for (const auto m_idx : cache.active_m_idxs) {
+        const auto &footprint = cache.footprints[m_idx];
+        if (footprint.rad > 0) {
+            continue;
+        }
+
+        for (const auto &pos : footprint.grids) {
+            apply_monster_lite(floor_ptr, pos);
+        }
     }
 
     RedrawingFlagsUpdater::get_instance().set_flag(StatusRecalculatingFlag::DELAY_VISIBILITY);
@@ -379,4 +551,5 @@ void clear_mon_lite(FloorType *floor_ptr)
     }
 
     floor_ptr->mon_lite_n = 0;
+    cache.is_valid = false;
 }
@@ -9,6 +9,7 @@
 #include "monster-race/race-flags7.h"
 #include "monster-race/race-indice-types.h"
 #include "monster/monster-info.h"
+#include "monster/monster-spatial-index.h"
 #include "monster/monster-status-setter.h"
 #include "monster/monster-status.h"
 #include "system/floor-type-definition.h"
@@ -97,7 +98,9 @@ void delete_monster_idx(PlayerType *player_ptr, MONSTER_IDX i)
     }
 
     *m_ptr = {};
+    MonsterSpatialIndex::get_instance().update(*floor_ptr, i);
     floor_ptr->m_cnt--;
+    floor_ptr->m_free_list.push_back(i);
     lite_spot(player_ptr, y, x);
     if (r_ptr->brightness_flags.has_any_of(ld_mask)) {
         RedrawingFlagsUpdater::get_instance().set_flag(StatusRecalculatingFlag::MONSTER_LITE);
@@ -134,6 +137,8 @@ void wipe_monsters_list(PlayerType *player_ptr)
 
     floor_ptr->m_max = 1;
     floor_ptr->m_cnt = 0;
+    floor_ptr->m_free_list.clear();
+    MonsterSpatialIndex::get_instance().invalidate();
     for (int i = 0; i < MAX_MTIMED; i++) {
         floor_ptr->mproc_max[i] = 0;
     }
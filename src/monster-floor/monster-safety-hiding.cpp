@@ -35,6 +35,10 @@ static coordinate_candidate sweep_safe_coordinate(PlayerType *player_ptr, MONSTE
     coordinate_candidate candidate = init_coordinate_candidate();
     auto *floor_ptr = player_ptr->current_floor_ptr;
     auto *m_ptr = &player_ptr->current_floor_ptr->m_list[m_idx];
+    auto *r_ptr = &m_ptr->get_monrace();
+    BIT_FLAGS16 riding_mode = (m_idx == player_ptr->riding) ? CEM_RIDING : 0;
+    const auto is_flowing = m_ptr->mflag2.has_not(MonsterConstantFlagType::NOFLOW);
+    const auto max_dist = floor_ptr->grid_array[m_ptr->fy][m_ptr->fx].get_distance(r_ptr) + 2 * d;
     for (POSITION i = 0, dx = x_offsets[0], dy = y_offsets[0]; dx != 0 || dy != 0; i++, dx = x_offsets[i], dy = y_offsets[i]) {
         POSITION y = m_ptr->fy + dy;
         POSITION x = m_ptr->fx + dx;
@@ -42,21 +46,18 @@ static coordinate_candidate sweep_safe_coordinate(PlayerType *player_ptr, MONSTE
             continue;
         }
 
-        auto *r_ptr = &m_ptr->get_monrace();
         Grid *g_ptr;
         g_ptr = &floor_ptr->grid_array[y][x];
-
-        BIT_FLAGS16 riding_mode = (m_idx == player_ptr->riding) ? CEM_RIDING : 0;
         if (!monster_can_cross_terrain(player_ptr, g_ptr->feat, r_ptr, riding_mode)) {
             continue;
         }
 
-        if (m_ptr->mflag2.has_not(MonsterConstantFlagType::NOFLOW)) {
+        if (is_flowing) {
             byte dist = g_ptr->get_distance(r_ptr);
             if (dist == 0) {
                 continue;
             }
-            if (dist > floor_ptr->grid_array[m_ptr->fy][m_ptr->fx].get_distance(r_ptr) + 2 * d) {
+            if (dist > max_dist) {
                 continue;
             }
         }
@@ -143,16 +144,18 @@ static void sweep_hiding_candidate(
         if (!monster_can_enter(player_ptr, y, x, r_ptr, 0)) {
             continue;
         }
-        if (projectable(player_ptr, player_ptr->y, player_ptr->x, y, x) || !clean_shot(player_ptr, m_ptr->fy, m_ptr->fx, y, x, false)) {
+        POSITION dis = distance(y, x, player_ptr->y, player_ptr->x);
+        if (dis >= candidate->gdis || dis < 2) {
             continue;
         }
 
-        POSITION dis = distance(y, x, player_ptr->y, player_ptr->x);
-        if (dis < candidate->gdis && dis >= 2) {
-            candidate->gy = y;
-            candidate->gx = x;
-            candidate->gdis = dis;
+        if (projectable(player_ptr, player_ptr->y, player_ptr->x, y, x) || !clean_shot(player_ptr, m_ptr->fy, m_ptr->fx, y, x, false)) {
+            continue;
         }
+
+        candidate->gy = y;
+        candidate->gx = x;
+        candidate->gdis = dis;
     }
 }
 
@@ -8,6 +8,7 @@
 #include "monster/monster-describer.h"
 #include "monster/monster-description-types.h"
 #include "monster/monster-info.h"
+#include "monster/monster-spatial-index.h"
 #include "monster/monster-status.h"
 #include "system/floor-type-definition.h"
 #include "system/grid-type-definition.h"
@@ -77,13 +78,10 @@ static void compact_monsters_aux(PlayerType *player_ptr, MONSTER_IDX i1, MONSTER
 
     floor_ptr->m_list[i2] = floor_ptr->m_list[i1];
     floor_ptr->m_list[i1] = {};
+    MonsterSpatialIndex::get_instance().update(*floor_ptr, i1);
+    MonsterSpatialIndex::get_instance().update(*floor_ptr, i2);
 
-    for (int i = 0; i < MAX_MTIMED; i++) {
-        int mproc_idx = get_mproc_idx(floor_ptr, i1, i);
-        if (mproc_idx >= 0) {
-            floor_ptr->mproc_list[i][mproc_idx] = i2;
-        }
-    }
+    mproc_move(floor_ptr, i1, i2);
 }
 
 /*!
@@ -159,4 +157,7 @@ void compact_monsters(PlayerType *player_ptr, int size)
         compact_monsters_aux(player_ptr, floor_ptr->m_max - 1, i);
         floor_ptr->m_max--;
     }
+
+    /* No holes are left below m_max */
+    floor_ptr->m_free_list.clear();
 }
@@ -57,10 +57,22 @@
  * @brief モンスター配列の空きを探す / Acquires and returns the index of a "free" monster.
  * @return 利用可能なモンスター配列の添字
  * @details
+ * 削除で空いた添字を最優先で再利用し、無ければ配列の末尾を伸ばす.
+ * 空きの記録から漏れた添字に備え、最後に配列全体を探す.
  * This routine should almost never fail, but it *can* happen.
  */
 MONSTER_IDX m_pop(FloorType *floor_ptr)
 {
+    /* Reuse a slot freed by delete_monster_idx() */
+    while (!floor_ptr->m_free_list.empty()) {
+        const auto i = floor_ptr->m_free_list.back();
+        floor_ptr->m_free_list.pop_back();
+        if ((i < floor_ptr->m_max) && !floor_ptr->m_list[i].is_valid()) {
+            floor_ptr->m_cnt++;
+            return i;
+        }
+    }
+
     /* Normal allocation */
     if (floor_ptr->m_max < w_ptr->max_m_idx) {
         MONSTER_IDX i = floor_ptr->m_max;
@@ -68,6 +68,8 @@
 #include "system/redrawing-flags-updater.h"
 #include "target/projection-path-calculator.h"
 #include "view/display-messages.h"
+#include <algorithm>
+#include <vector>
 
 void decide_drop_from_monster(PlayerType *player_ptr, MONSTER_IDX m_idx, bool is_riding_mon);
 bool process_stealth(PlayerType *player_ptr, MONSTER_IDX m_idx);
@@ -82,7 +84,8 @@ bool cast_spell(PlayerType *player_ptr, MONSTER_IDX m_idx, bool aware);
 bool process_monster_fear(PlayerType *player_ptr, turn_flags *turn_flags_ptr, MONSTER_IDX m_idx);
 
 void sweep_monster_process(PlayerType *player_ptr);
-bool decide_process_continue(PlayerType *player_ptr, MonsterEntity *m_ptr);
+bool decide_process_continue(PlayerType *player_ptr, MONSTER_IDX m_idx);
+static bool is_monster_processed(PlayerType *player_ptr, const MonsterEntity &monster, MONSTER_IDX m_idx);
 
 /*!
  * @brief モンスター単体の1ターン行動処理メインルーチン /
@@ -599,16 +602,14 @@ void process_monsters(PlayerType *player_ptr)
  */
 void sweep_monster_process(PlayerType *player_ptr)
 {
+    if (player_ptr->leaving || player_ptr->wild_mode) {
+        return;
+    }
+
     auto *floor_ptr = player_ptr->current_floor_ptr;
     for (MONSTER_IDX i = floor_ptr->m_max - 1; i >= 1; i--) {
-        MonsterEntity *m_ptr;
-        m_ptr = &floor_ptr->m_list[i];
-
-        if (player_ptr->leaving) {
-            return;
-        }
-
-        if (!m_ptr->is_valid() || player_ptr->wild_mode) {
+        auto *m_ptr = &floor_ptr->m_list[i];
+        if (!m_ptr->is_valid()) {
             continue;
         }
 
@@ -617,7 +618,7 @@ void sweep_monster_process(PlayerType *player_ptr)
             continue;
         }
 
-        if ((m_ptr->cdis >= MAX_MONSTER_SENSING) || !decide_process_continue(player_ptr, m_ptr)) {
+        if ((m_ptr->cdis >= MAX_MONSTER_SENSING) || !decide_process_continue(player_ptr, i)) {
             continue;
         }
 
@@ -641,32 +642,128 @@ void sweep_monster_process(PlayerType *player_ptr)
     }
 }
 
+/*!
+ * @brief モンスターが侵入者に気付く距離を得る
+ * @param monster モンスターへの参照
+ * @param m_idx モンスターID
+ * @return 気付く距離
+ * @details 全モンスターについて毎ゲームターン参照するが、種族情報は種族IDからの探索を伴うため、
+ * m_list の添字ごとに種族IDと組にして保存しておき、種族が変わった時だけ引き直す.
+ */
+static POSITION get_monster_sensing_range(const MonsterEntity &monster, MONSTER_IDX m_idx)
+{
+    static std::vector<std::pair<MonsterRaceId, POSITION>> sensing_ranges;
+    if (sensing_ranges.size() <= static_cast<size_t>(m_idx)) {
+        sensing_ranges.resize(m_idx + 1, { MonsterRaceId::PLAYER, 0 });
+    }
+
+    auto &[monrace_id, aaf] = sensing_ranges[m_idx];
+    if (monrace_id != monster.r_idx) {
+        monrace_id = monster.r_idx;
+        aaf = monster.get_monrace().aaf;
+    }
+
+    return monster.is_pet() ? std::min<POSITION>(aaf, MAX_PLAYER_SIGHT) : aaf;
+}
+
 /*!
  * @brief 後続のモンスター処理が必要かどうか判定する (要調査)
  * @param player_ptr プレイヤーへの参照ポインタ
- * @param m_ptr モンスターへの参照ポインタ
+ * @param m_idx モンスターID
  * @return 後続処理が必要ならTRUE
  */
-bool decide_process_continue(PlayerType *player_ptr, MonsterEntity *m_ptr)
+bool decide_process_continue(PlayerType *player_ptr, MONSTER_IDX m_idx)
 {
-    const auto &monrace = m_ptr->get_monrace();
+    auto *m_ptr = &player_ptr->current_floor_ptr->m_list[m_idx];
     if (!player_ptr->no_flowed) {
         m_ptr->mflag2.reset(MonsterConstantFlagType::NOFLOW);
     }
 
-    if (m_ptr->cdis <= (m_ptr->is_pet() ? (monrace.aaf > MAX_PLAYER_SIGHT ? MAX_PLAYER_SIGHT : monrace.aaf) : monrace.aaf)) {
+    return is_monster_processed(player_ptr, *m_ptr, m_idx);
+}
+
+/*!
+ * @brief モンスターが行動値を蓄積する (プレイヤーに関わる) 状況にいるか判定する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param monster モンスターへの参照
+ * @param m_idx モンスターID
+ * @return 蓄積するならtrue
+ */
+static bool is_monster_processed(PlayerType *player_ptr, const MonsterEntity &monster, MONSTER_IDX m_idx)
+{
+    if (monster.cdis <= get_monster_sensing_range(monster, m_idx)) {
         return true;
     }
 
-    auto should_continue = (m_ptr->cdis <= MAX_PLAYER_SIGHT) || AngbandSystem::get_instance().is_phase_out();
-    should_continue &= player_ptr->current_floor_ptr->has_los({ m_ptr->fy, m_ptr->fx }) || has_aggravate(player_ptr);
+    auto should_continue = (monster.cdis <= MAX_PLAYER_SIGHT) || AngbandSystem::get_instance().is_phase_out();
+    should_continue &= player_ptr->current_floor_ptr->has_los({ monster.fy, monster.fx }) || has_aggravate(player_ptr);
     if (should_continue) {
         return true;
     }
 
-    if (m_ptr->target_y) {
+    if (monster.target_y) {
         return true;
     }
 
     return false;
 }
+
+/*!
+ * @brief どのモンスターも行動しないゲームターンをまとめて経過させる
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param max_turns 経過させるゲームターン数の上限
+ * @return 経過させたゲームターン数
+ * @details sweep_monster_process() を続けて呼んだ時、行動値が溜まり切るモンスターが現れるまでの間は
+ * 行動値の蓄積と NOFLOW フラグの解除しか起こらない. その間の結果をまとめて反映する.
+ * 生まれたばかりのモンスターがいる場合は何もしない.
+ */
+int skip_idle_monster_turns(PlayerType *player_ptr, int max_turns)
+{
+    if (player_ptr->leaving || player_ptr->wild_mode) {
+        return max_turns;
+    }
+
+    static std::vector<std::pair<MONSTER_IDX, byte>> sensing_monsters;
+    sensing_monsters.clear();
+    auto &floor = *player_ptr->current_floor_ptr;
+    auto turns = max_turns;
+    for (MONSTER_IDX i = floor.m_max - 1; i >= 1; i--) {
+        const auto &monster = floor.m_list[i];
+        if (!monster.is_valid()) {
+            continue;
+        }
+
+        if (monster.mflag.has(MonsterTemporaryFlagType::BORN)) {
+            return 0;
+        }
+
+        if (monster.cdis >= MAX_MONSTER_SENSING) {
+            continue;
+        }
+
+        if (!is_monster_processed(player_ptr, monster, i)) {
+            sensing_monsters.emplace_back(i, 0);
+            continue;
+        }
+
+        const auto speed = (player_ptr->riding == i) ? player_ptr->pspeed : monster.get_temporary_speed();
+        const auto energy = speed_to_energy(speed);
+        turns = std::min<int>(turns, (monster.energy_need - 1) / energy);
+        if (turns <= 0) {
+            return 0;
+        }
+
+        sensing_monsters.emplace_back(i, energy);
+    }
+
+    for (const auto &[m_idx, energy] : sensing_monsters) {
+        auto &monster = floor.m_list[m_idx];
+        if (!player_ptr->no_flowed) {
+            monster.mflag2.reset(MonsterConstantFlagType::NOFLOW);
+        }
+
+        monster.energy_need -= static_cast<ACTION_ENERGY>(energy * turns);
+    }
+
+    return turns;
+}
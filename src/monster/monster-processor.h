@@ -5,3 +5,4 @@
 class PlayerType;
 void process_monsters(PlayerType *player_ptr);
 void process_monster(PlayerType *player_ptr, MONSTER_IDX m_idx);
+int skip_idle_monster_turns(PlayerType *player_ptr, int max_turns);
@@ -0,0 +1,327 @@
+/*!
+ * @brief フロア上のモンスターの位置索引
+ * @details
+ * 感知魔法、モンスターの光源、ペットの攻撃対象選びなどは特定の範囲にいるモンスターだけを必要とする.
+ * m_list 全体の走査を、範囲に掛かる区画の走査に置き換える.
+ * 返すモンスターIDは m_list を先頭から走査した時と同じ昇順に並べる.
+ */
+
+#include "monster/monster-spatial-index.h"
+#include "floor/floor-base-definitions.h"
+#include "floor/geometry.h"
+#include "system/floor-type-definition.h"
+#include "system/monster-entity.h"
+#include "world/world.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+MonsterSpatialIndex MonsterSpatialIndex::instance{};
+
+MonsterSpatialIndex &MonsterSpatialIndex::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief 矩形の範囲にいるモンスターを集める
+ * @param floor 対象のフロアへの参照
+ * @param top_left 範囲の左上の座標
+ * @param bottom_right 範囲の右下の座標 (範囲に含む)
+ * @return 範囲にいるモンスターIDの昇順の一覧
+ */
+std::vector<MONSTER_IDX> MonsterSpatialIndex::collect_in_rect(const FloorType &floor, const Pos2D &top_left, const Pos2D &bottom_right)
+{
+    const auto is_inside = [&top_left, &bottom_right](const MonsterEntity &monster) {
+        return (monster.fy >= top_left.y) && (monster.fy <= bottom_right.y) && (monster.fx >= top_left.x) && (monster.fx <= bottom_right.x);
+    };
+
+    std::vector<MONSTER_IDX> m_idxs;
+    if (!this->prepare(floor)) {
+        for (MONSTER_IDX m_idx = 1; m_idx < floor.m_max; m_idx++) {
+            const auto &monster = floor.m_list[m_idx];
+            if (monster.is_valid() && is_inside(monster)) {
+                m_idxs.push_back(m_idx);
+            }
+        }
+
+        return m_idxs;
+    }
+
+    const auto by1 = std::max(top_left.y, 0) / BUCKET_SIZE;
+    const auto bx1 = std::max(top_left.x, 0) / BUCKET_SIZE;
+    const auto by2 = std::min(bottom_right.y / BUCKET_SIZE, this->bucket_height - 1);
+    const auto bx2 = std::min(bottom_right.x / BUCKET_SIZE, this->bucket_width - 1);
+    for (auto by = by1; by <= by2; by++) {
+        for (auto bx = bx1; bx <= bx2; bx++) {
+            for (const auto m_idx : this->buckets[by * this->bucket_width + bx]) {
+                const auto &monster = floor.m_list[m_idx];
+                if (monster.is_valid() && is_inside(monster)) {
+                    m_idxs.push_back(m_idx);
+                }
+            }
+        }
+    }
+
+    std::sort(m_idxs.begin(), m_idxs.end());
+    return m_idxs;
+}
+
+/*!
+ * @brief 指定の座標から一定の距離以内にいるモンスターを集める
+ * @param floor 対象のフロアへの参照
+ * @param center 中心の座標
+ * @param dist 距離 (distance() による)
+ * @return 範囲にいるモンスターIDの昇順の一覧
+ */
+std::vector<MONSTER_IDX> MonsterSpatialIndex::collect_within_distance(const FloorType &floor, const Pos2D &center, int dist)
+{
+    auto m_idxs = this->collect_in_rect(floor, { center.y - dist, center.x - dist }, { center.y + dist, center.x + dist });
+    const auto is_far = [&floor, &center, dist](MONSTER_IDX m_idx) {
+        const auto &monster = floor.m_list[m_idx];
+        return distance(center.y, center.x, monster.fy, monster.fx) > dist;
+    };
+
+    m_idxs.erase(std::remove_if(m_idxs.begin(), m_idxs.end(), is_far), m_idxs.end());
+    return m_idxs;
+}
+
+/*!
+ * @brief 指定の座標から近い順にモンスターを調べ、条件を満たす最初のモンスターを探す
+ * @param floor 対象のフロアへの参照
+ * @param center 中心の座標
+ * @param range 調べる範囲 (中心との縦・横の差の上限)
+ * @param get_order 同じ距離のモンスターを調べる順序を返す関数 (小さい値から調べる)
+ * @param accept 条件を満たすならtrueを返す関数
+ * @return 見つかったモンスターID. いなければ0
+ * @details 中心の区画から外側へ1周ずつ区画を広げ、まだ調べていない区画にいるモンスターより近いことが確定した候補から順に判定する.
+ * 近くで見つかれば遠くの区画は調べない.
+ */
+MONSTER_IDX MonsterSpatialIndex::find_nearest(const FloorType &floor, const Pos2D &center, int range, const std::function<int(MONSTER_IDX)> &get_order, const std::function<bool(MONSTER_IDX)> &accept)
+{
+    // 距離、同距離内の順序、モンスターIDを1つの整数に詰めて並べる. 未判定のものを昇順に保つ
+    constexpr auto id_bits = 20;
+    constexpr auto id_mask = (uint64_t(1) << id_bits) - 1;
+    const auto make_key = [&get_order](int dist, MONSTER_IDX m_idx) {
+        return (uint64_t(dist) << (id_bits * 2)) | ((uint64_t(get_order(m_idx)) & id_mask) << id_bits) | uint64_t(m_idx);
+    };
+
+    std::vector<std::pair<int, MONSTER_IDX>> found;
+    std::vector<uint64_t> candidates;
+    size_t next = 0;
+    for (auto ring = 0;; ring++) {
+        found.clear();
+        const auto next_min_dist = this->collect_ring(floor, center, ring, range, found);
+        candidates.erase(candidates.begin(), candidates.begin() + next);
+        next = 0;
+        for (const auto &[dist, m_idx] : found) {
+            candidates.push_back(make_key(dist, m_idx));
+        }
+
+        std::sort(candidates.begin(), candidates.end());
+        for (; next < candidates.size(); next++) {
+            const auto key = candidates[next];
+            if ((next_min_dist >= 0) && (static_cast<int>(key >> (id_bits * 2)) >= next_min_dist)) {
+                break;
+            }
+
+            const auto m_idx = static_cast<MONSTER_IDX>(key & id_mask);
+            if (accept(m_idx)) {
+                return m_idx;
+            }
+        }
+
+        if (next_min_dist < 0) {
+            return 0;
+        }
+    }
+}
+
+/*!
+ * @brief モンスターの現在の状態を索引に反映する
+ * @param floor モンスターのいるフロアへの参照
+ * @param m_idx モンスターID
+ * @details 配置・移動・削除のいずれの後にも呼んでよい. 索引が作られていなければ何もしない.
+ */
+void MonsterSpatialIndex::update(const FloorType &floor, MONSTER_IDX m_idx)
+{
+    if (!w_ptr->character_dungeon) {
+        this->is_valid = false;
+        return;
+    }
+
+    if (!this->is_valid || (this->floor_ptr != &floor) || (m_idx <= 0)) {
+        return;
+    }
+
+    this->move_to_bucket(m_idx, this->get_bucket_index(floor, m_idx));
+}
+
+/*!
+ * @brief 索引を破棄する
+ * @details フロアの生成・読み込みや全モンスターの消去の時に呼ぶ. 次に使う時に作り直す.
+ */
+void MonsterSpatialIndex::invalidate()
+{
+    this->is_valid = false;
+}
+
+bool MonsterSpatialIndex::prepare(const FloorType &floor)
+{
+    if (!w_ptr->character_dungeon) {
+        this->is_valid = false;
+        return false;
+    }
+
+    const auto bucket_height = (floor.height + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    const auto bucket_width = (floor.width + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    if (!this->is_valid || (this->floor_ptr != &floor) || (this->bucket_height != bucket_height) || (this->bucket_width != bucket_width)) {
+        this->build(floor);
+    }
+
+    return true;
+}
+
+void MonsterSpatialIndex::build(const FloorType &floor)
+{
+    this->floor_ptr = &floor;
+    this->bucket_height = (floor.height + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    this->bucket_width = (floor.width + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    this->buckets.assign(this->bucket_height * this->bucket_width, {});
+    this->monster_buckets.assign(floor.m_list.size(), -1);
+    this->is_valid = true;
+    for (MONSTER_IDX m_idx = 1; m_idx < floor.m_max; m_idx++) {
+        this->move_to_bucket(m_idx, this->get_bucket_index(floor, m_idx));
+    }
+}
+
+int MonsterSpatialIndex::get_bucket_index(const FloorType &floor, MONSTER_IDX m_idx) const
+{
+    const auto &monster = floor.m_list[m_idx];
+    if (!monster.is_valid() || (monster.fy < 0) || (monster.fx < 0) || (monster.fy >= floor.height) || (monster.fx >= floor.width)) {
+        return -1;
+    }
+
+    return (monster.fy / BUCKET_SIZE) * this->bucket_width + (monster.fx / BUCKET_SIZE);
+}
+
+/*!
+ * @brief 中心の区画から指定の周回にある区画のうち、範囲内にいるモンスターを集める
+ * @param found 距離とモンスターIDの組を追加する配列
+ * @return 次の周回以降にいるモンスターの距離の下限. 以降に調べる区画が無ければ-1
+ * @details 調べ終えた区画の外にいるモンスターは、中心からその区画の縁までの縦か横の差以上離れており、distance() はその差以上になる.
+ * @details 索引を使えない時は周回0で全モンスターを集める.
+ */
+int MonsterSpatialIndex::collect_ring(const FloorType &floor, const Pos2D &center, int ring, int range, std::vector<std::pair<int, MONSTER_IDX>> &found)
+{
+    const auto add = [&floor, &center, range, &found](MONSTER_IDX m_idx) {
+        const auto &monster = floor.m_list[m_idx];
+        if (!monster.is_valid() || (std::abs(monster.fy - center.y) > range) || (std::abs(monster.fx - center.x) > range)) {
+            return;
+        }
+
+        found.emplace_back(get_distance(std::abs(monster.fy - center.y), std::abs(monster.fx - center.x)), m_idx);
+    };
+
+    if (!this->prepare(floor)) {
+        for (MONSTER_IDX m_idx = 1; m_idx < floor.m_max; m_idx++) {
+            add(m_idx);
+        }
+
+        return -1;
+    }
+
+    const auto cby = std::clamp(center.y / BUCKET_SIZE, 0, this->bucket_height - 1);
+    const auto cbx = std::clamp(center.x / BUCKET_SIZE, 0, this->bucket_width - 1);
+    const auto top = std::max(center.y - range, 0) / BUCKET_SIZE;
+    const auto left = std::max(center.x - range, 0) / BUCKET_SIZE;
+    const auto bottom = std::min((center.y + range) / BUCKET_SIZE, this->bucket_height - 1);
+    const auto right = std::min((center.x + range) / BUCKET_SIZE, this->bucket_width - 1);
+    for (auto by = std::max(top, cby - ring); by <= std::min(bottom, cby + ring); by++) {
+        const auto is_edge_row = (by == cby - ring) || (by == cby + ring);
+        for (auto bx = std::max(left, cbx - ring); bx <= std::min(right, cbx + ring); bx++) {
+            if (!is_edge_row && (bx != cbx - ring) && (bx != cbx + ring)) {
+                continue;
+            }
+
+            for (const auto m_idx : this->buckets[by * this->bucket_width + bx]) {
+                add(m_idx);
+            }
+        }
+    }
+
+    constexpr auto unreached = std::numeric_limits<int>::max();
+    auto next_min_dist = unreached;
+    if (cby - ring > top) {
+        next_min_dist = std::min(next_min_dist, center.y - (cby - ring) * BUCKET_SIZE + 1);
+    }
+
+    if (cby + ring < bottom) {
+        next_min_dist = std::min(next_min_dist, (cby + ring + 1) * BUCKET_SIZE - center.y);
+    }
+
+    if (cbx - ring > left) {
+        next_min_dist = std::min(next_min_dist, center.x - (cbx - ring) * BUCKET_SIZE + 1);
+    }
+
+    if (cbx + ring < right) {
+        next_min_dist = std::min(next_min_dist, (cbx + ring + 1) * BUCKET_SIZE - center.x);
+    }
+
+    if ((next_min_dist == unreached) || (next_min_dist > range)) {
+        return -1;
+    }
+
+    return next_min_dist;
+}
+
+/*!
+ * @brief 縦横の差から distance() と同じ距離を求める
+ * @details distance() は反復計算を伴うため、フロアの大きさの範囲で表にしておく.
+ */
+int MonsterSpatialIndex::get_distance(int dy, int dx)
+{
+    static std::vector<int16_t> table;
+    if (table.empty()) {
+        table.resize(MAX_HGT * MAX_WID);
+        for (auto y = 0; y < MAX_HGT; y++) {
+            for (auto x = 0; x < MAX_WID; x++) {
+                table[y * MAX_WID + x] = static_cast<int16_t>(distance(0, 0, y, x));
+            }
+        }
+    }
+
+    if ((dy >= MAX_HGT) || (dx >= MAX_WID)) {
+        return distance(0, 0, dy, dx);
+    }
+
+    return table[dy * MAX_WID + dx];
+}
+
+void MonsterSpatialIndex::move_to_bucket(MONSTER_IDX m_idx, int bucket_index)
+{
+    if (this->monster_buckets.size() <= static_cast<size_t>(m_idx)) {
+        this->monster_buckets.resize(m_idx + 1, -1);
+    }
+
+    auto &current = this->monster_buckets[m_idx];
+    if (current == bucket_index) {
+        return;
+    }
+
+    if (current >= 0) {
+        auto &bucket = this->buckets[current];
+        const auto it = std::find(bucket.begin(), bucket.end(), m_idx);
+        if (it != bucket.end()) {
+            *it = bucket.back();
+            bucket.pop_back();
+        }
+    }
+
+    if (bucket_index >= 0) {
+        this->buckets[bucket_index].push_back(m_idx);
+    }
+
+    current = bucket_index;
+}
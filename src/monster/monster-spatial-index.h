@@ -0,0 +1,56 @@
+#pragma once
+
+#include "system/angband.h"
+#include "util/point-2d.h"
+#include <functional>
+#include <utility>
+#include <vector>
+
+class FloorType;
+
+/*!
+ * @brief フロア上のモンスターの位置索引
+ * @details
+ * フロアを BUCKET_SIZE 四方の区画に分け、区画ごとにそこにいるモンスターのIDを保持する.
+ * 範囲内のモンスターを探す処理で m_list 全体を走査する代わりに、範囲に掛かる区画だけを調べる.
+ * モンスターの位置は update_monster() と削除・圧縮の処理で反映する.
+ * 索引はフロアの生成・読み込み時に破棄し、次に使う時に m_list から作り直す.
+ * フロアの生成中 (character_dungeon が偽の間) は索引を使わず m_list を走査する.
+ */
+class MonsterSpatialIndex {
+public:
+    MonsterSpatialIndex(const MonsterSpatialIndex &) = delete;
+    MonsterSpatialIndex(MonsterSpatialIndex &&) = delete;
+    MonsterSpatialIndex &operator=(const MonsterSpatialIndex &) = delete;
+    MonsterSpatialIndex &operator=(MonsterSpatialIndex &&) = delete;
+    ~MonsterSpatialIndex() = default;
+
+    static constexpr int BUCKET_SIZE = 8; //!< 1区画の一辺のマス数
+
+    static MonsterSpatialIndex &get_instance();
+
+    std::vector<MONSTER_IDX> collect_in_rect(const FloorType &floor, const Pos2D &top_left, const Pos2D &bottom_right);
+    std::vector<MONSTER_IDX> collect_within_distance(const FloorType &floor, const Pos2D &center, int dist);
+    MONSTER_IDX find_nearest(const FloorType &floor, const Pos2D &center, int range, const std::function<int(MONSTER_IDX)> &get_order, const std::function<bool(MONSTER_IDX)> &accept);
+    void update(const FloorType &floor, MONSTER_IDX m_idx);
+    void invalidate();
+
+private:
+    MonsterSpatialIndex() = default;
+
+    static MonsterSpatialIndex instance;
+
+    const FloorType *floor_ptr = nullptr;
+    int bucket_height = 0;
+    int bucket_width = 0;
+    bool is_valid = false;
+    std::vector<std::vector<MONSTER_IDX>> buckets{};
+    std::vector<int> monster_buckets{}; //!< モンスターIDごとの登録先の区画 (未登録なら-1)
+
+    bool prepare(const FloorType &floor);
+    void build(const FloorType &floor);
+    int get_bucket_index(const FloorType &floor, MONSTER_IDX m_idx) const;
+    int collect_ring(const FloorType &floor, const Pos2D &center, int ring, int range, std::vector<std::pair<int, MONSTER_IDX>> &found);
+    void move_to_bucket(MONSTER_IDX m_idx, int bucket_index);
+    static int get_distance(int dy, int dx);
+};
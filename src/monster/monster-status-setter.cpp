@@ -62,20 +62,6 @@ void anger_monster(PlayerType *player_ptr, MonsterEntity *m_ptr)
     chg_virtue(player_ptr, Virtue::COMPASSION, -1);
 }
 
-/*!
- * @brief モンスターの時限ステータスリストを削除
- * @param floor_ptr 現在フロアへの参照ポインタ
- * @return m_idx モンスターの参照ID
- * @return mproc_type 削除したいモンスターの時限ステータスID
- */
-static void mproc_remove(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type)
-{
-    int mproc_idx = get_mproc_idx(floor_ptr, m_idx, mproc_type);
-    if (mproc_idx >= 0) {
-        floor_ptr->mproc_list[mproc_type][mproc_idx] = floor_ptr->mproc_list[mproc_type][--floor_ptr->mproc_max[mproc_type]];
-    }
-}
-
 /*!
  * @brief モンスターの睡眠状態値をセットする。0で起きる。 /
  * Set "m_ptr->mtimed[MTIMED_CSLEEP]", notice observable changes
@@ -28,6 +28,8 @@
 #include "util/bit-flags-calculator.h"
 #include "view/display-messages.h"
 #include "world/world.h"
+#include <algorithm>
+#include <bit>
 #if JP
 #else
 #include "monster/monster-description-types.h"
@@ -101,19 +103,87 @@ int mon_damage_mod(PlayerType *player_ptr, MonsterEntity *m_ptr, int dam, bool i
  * @return m_idx モンスターの参照ID
  * @return mproc_type モンスターの時限ステータスID
  * @return 残りターン値
+ * @details mproc_index は mproc_list の変更に合わせて更新する. 一覧を空にした後の古い値は mproc_list との突き合わせで弾く.
  */
 int get_mproc_idx(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type)
 {
-    const auto &cur_mproc_list = floor_ptr->mproc_list[mproc_type];
-    for (int i = floor_ptr->mproc_max[mproc_type] - 1; i >= 0; i--) {
-        if (cur_mproc_list[i] == m_idx) {
-            return i;
+    const int mproc_idx = floor_ptr->mproc_index[mproc_type][m_idx];
+    if ((mproc_idx < 0) || (mproc_idx >= floor_ptr->mproc_max[mproc_type]) || (floor_ptr->mproc_list[mproc_type][mproc_idx] != m_idx)) {
+        return -1;
+    }
+
+    return mproc_idx;
+}
+
+/*!
+ * @brief 睡眠中のモンスターの起床判定を行う距離の上限を求める
+ * @param monster モンスターへの参照
+ * @return 距離の上限
+ * @details 起床判定は感知範囲 (ペットは視界で頭打ち) 内か、視界内で視線が通る時にだけ乱数を使う.
+ * これより遠い睡眠中のモンスターは判定しても何も起きない.
+ */
+static POSITION calc_sleep_check_range(const MonsterEntity &monster)
+{
+    const auto range = std::max<POSITION>(monster.get_monrace().aaf, MAX_PLAYER_SIGHT);
+    return std::min<POSITION>(range, MAX_MONSTER_SENSING - 1);
+}
+
+static void set_sleep_check_bit(FloorType *floor_ptr, int mproc_idx, bool is_due)
+{
+    const auto mask = uint64_t(1) << (mproc_idx & 63);
+    auto &word = floor_ptr->sleep_check_bits[mproc_idx >> 6];
+    word = is_due ? (word | mask) : (word & ~mask);
+}
+
+static bool test_sleep_check_bit(const FloorType *floor_ptr, int mproc_idx)
+{
+    return ((floor_ptr->sleep_check_bits[mproc_idx >> 6] >> (mproc_idx & 63)) & 1) != 0;
+}
+
+/*!
+ * @brief 起床判定の対象になり得る睡眠中モンスターを mproc_list 上の位置の降順に探す
+ * @param floor_ptr 現在フロアへの参照ポインタ
+ * @param mproc_idx 探し始める位置
+ * @return mproc_idx 以下で最も後ろにある対象の位置. なければ-1
+ */
+static int find_sleep_check(const FloorType *floor_ptr, int mproc_idx)
+{
+    for (auto word_idx = mproc_idx >> 6; word_idx >= 0; word_idx--) {
+        auto word = floor_ptr->sleep_check_bits[word_idx];
+        if (word_idx == (mproc_idx >> 6)) {
+            word &= ~uint64_t(0) >> (63 - (mproc_idx & 63));
+        }
+
+        if (word != 0) {
+            return word_idx * 64 + std::bit_width(word) - 1;
         }
     }
 
     return -1;
 }
 
+/*!
+ * @brief 睡眠中のモンスターが起床判定の対象になり得るかを更新する
+ * @param floor_ptr 現在フロアへの参照ポインタ
+ * @param m_idx モンスターの参照ID
+ * @param update_range 種族から距離の上限を求め直すならtrue
+ * @details モンスターの距離 (cdis) や種族が変わった時に呼ぶ. 眠っていないモンスターに対しては何もしない.
+ */
+void update_sleep_check(FloorType *floor_ptr, MONSTER_IDX m_idx, bool update_range)
+{
+    const auto mproc_idx = get_mproc_idx(floor_ptr, m_idx, MTIMED_CSLEEP);
+    if (mproc_idx < 0) {
+        return;
+    }
+
+    const auto &monster = floor_ptr->m_list[m_idx];
+    if (update_range) {
+        floor_ptr->sleep_check_ranges[m_idx] = calc_sleep_check_range(monster);
+    }
+
+    set_sleep_check_bit(floor_ptr, mproc_idx, monster.cdis <= floor_ptr->sleep_check_ranges[m_idx]);
+}
+
 /*!
  * @brief モンスターの時限ステータスリストを追加する
  * @param floor_ptr 現在フロアへの参照ポインタ
@@ -122,9 +192,63 @@ int get_mproc_idx(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type)
  */
 void mproc_add(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type)
 {
-    if (floor_ptr->mproc_max[mproc_type] < w_ptr->max_m_idx) {
-        floor_ptr->mproc_list[mproc_type][floor_ptr->mproc_max[mproc_type]++] = (int16_t)m_idx;
+    if (floor_ptr->mproc_max[mproc_type] >= w_ptr->max_m_idx) {
+        return;
+    }
+
+    const auto mproc_idx = floor_ptr->mproc_max[mproc_type]++;
+    floor_ptr->mproc_list[mproc_type][mproc_idx] = (int16_t)m_idx;
+    floor_ptr->mproc_index[mproc_type][m_idx] = mproc_idx;
+    if (mproc_type == MTIMED_CSLEEP) {
+        update_sleep_check(floor_ptr, m_idx, true);
+    }
+}
+
+/*!
+ * @brief モンスターの時限ステータスリストを削除
+ * @param floor_ptr 現在フロアへの参照ポインタ
+ * @return m_idx モンスターの参照ID
+ * @return mproc_type 削除したいモンスターの時限ステータスID
+ * @details 末尾の要素を削除した位置へ移す. 起床判定の対象かどうかも一緒に移す.
+ */
+void mproc_remove(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type)
+{
+    const auto mproc_idx = get_mproc_idx(floor_ptr, m_idx, mproc_type);
+    if (mproc_idx < 0) {
+        return;
+    }
+
+    const auto last_idx = --floor_ptr->mproc_max[mproc_type];
+    const auto last_m_idx = floor_ptr->mproc_list[mproc_type][last_idx];
+    floor_ptr->mproc_list[mproc_type][mproc_idx] = last_m_idx;
+    floor_ptr->mproc_index[mproc_type][last_m_idx] = mproc_idx;
+    floor_ptr->mproc_index[mproc_type][m_idx] = -1;
+    if (mproc_type == MTIMED_CSLEEP) {
+        set_sleep_check_bit(floor_ptr, mproc_idx, test_sleep_check_bit(floor_ptr, last_idx));
+        set_sleep_check_bit(floor_ptr, last_idx, false);
+    }
+}
+
+/*!
+ * @brief モンスター配列の圧縮に合わせて時限ステータスリスト上のモンスターIDを付け替える
+ * @param floor_ptr 現在フロアへの参照ポインタ
+ * @param m_idx_from 移動元のモンスターID
+ * @param m_idx_to 移動先のモンスターID
+ */
+void mproc_move(FloorType *floor_ptr, MONSTER_IDX m_idx_from, MONSTER_IDX m_idx_to)
+{
+    for (int i = 0; i < MAX_MTIMED; i++) {
+        const auto mproc_idx = get_mproc_idx(floor_ptr, m_idx_from, i);
+        if (mproc_idx < 0) {
+            continue;
+        }
+
+        floor_ptr->mproc_list[i][mproc_idx] = (int16_t)m_idx_to;
+        floor_ptr->mproc_index[i][m_idx_to] = mproc_idx;
+        floor_ptr->mproc_index[i][m_idx_from] = -1;
     }
+
+    floor_ptr->sleep_check_ranges[m_idx_to] = floor_ptr->sleep_check_ranges[m_idx_from];
 }
 
 /*!
@@ -349,6 +473,14 @@ void process_monsters_mtimed(PlayerType *player_ptr, int mtimed_idx)
     }
 
     /* Process the monsters (backwards) */
+    if (mtimed_idx == MTIMED_CSLEEP) {
+        for (auto i = find_sleep_check(floor_ptr, floor_ptr->mproc_max[mtimed_idx] - 1); i >= 0; i = find_sleep_check(floor_ptr, i - 1)) {
+            process_monsters_mtimed_aux(player_ptr, cur_mproc_list[i], mtimed_idx);
+        }
+
+        return;
+    }
+
     for (auto i = floor_ptr->mproc_max[mtimed_idx] - 1; i >= 0; i--) {
         process_monsters_mtimed_aux(player_ptr, cur_mproc_list[i], mtimed_idx);
     }
@@ -19,3 +19,6 @@ void process_monsters_mtimed(PlayerType *player_ptr, int mtimed_idx);
 int get_mproc_idx(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type);
 void mproc_init(FloorType *floor_ptr);
 void mproc_add(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type);
+void mproc_remove(FloorType *floor_ptr, MONSTER_IDX m_idx, int mproc_type);
+void mproc_move(FloorType *floor_ptr, MONSTER_IDX m_idx_from, MONSTER_IDX m_idx_to);
+void update_sleep_check(FloorType *floor_ptr, MONSTER_IDX m_idx, bool update_range);
@@ -24,6 +24,7 @@
 #include "monster/monster-flag-types.h"
 #include "monster/monster-info.h"
 #include "monster/monster-processor-util.h"
+#include "monster/monster-spatial-index.h"
 #include "monster/monster-status.h"
 #include "monster/smart-learn-types.h"
 #include "player-base/player-class.h"
@@ -208,14 +209,17 @@ static um_type *initialize_um_type(PlayerType *player_ptr, um_type *um_ptr, MONS
     return um_ptr;
 }
 
-static POSITION decide_updated_distance(PlayerType *player_ptr, um_type *um_ptr)
+/*!
+ * @brief モンスターの cdis として記録するプレイヤーからの距離を求める
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param fy モンスターのY座標
+ * @param fx モンスターのX座標
+ * @return 1～255に丸めた距離
+ */
+static POSITION calc_monster_distance(PlayerType *player_ptr, POSITION fy, POSITION fx)
 {
-    if (!um_ptr->full) {
-        return um_ptr->m_ptr->cdis;
-    }
-
-    int dy = (player_ptr->y > um_ptr->fy) ? (player_ptr->y - um_ptr->fy) : (um_ptr->fy - player_ptr->y);
-    int dx = (player_ptr->x > um_ptr->fx) ? (player_ptr->x - um_ptr->fx) : (um_ptr->fx - player_ptr->x);
+    int dy = (player_ptr->y > fy) ? (player_ptr->y - fy) : (fy - player_ptr->y);
+    int dx = (player_ptr->x > fx) ? (player_ptr->x - fx) : (fx - player_ptr->x);
     POSITION distance = (dy > dx) ? (dy + (dx >> 1)) : (dx + (dy >> 1));
     if (distance > 255) {
         distance = 255;
@@ -225,6 +229,16 @@ static POSITION decide_updated_distance(PlayerType *player_ptr, um_type *um_ptr)
         distance = 1;
     }
 
+    return distance;
+}
+
+static POSITION decide_updated_distance(PlayerType *player_ptr, um_type *um_ptr)
+{
+    if (!um_ptr->full) {
+        return um_ptr->m_ptr->cdis;
+    }
+
+    const auto distance = calc_monster_distance(player_ptr, um_ptr->fy, um_ptr->fx);
     um_ptr->m_ptr->cdis = distance;
     return distance;
 }
@@ -587,6 +601,7 @@ static bool update_clear_monster(PlayerType *player_ptr, um_type *um_ptr)
  */
 void update_monster(PlayerType *player_ptr, MONSTER_IDX m_idx, bool full)
 {
+    MonsterSpatialIndex::get_instance().update(*player_ptr->current_floor_ptr, m_idx);
     um_type tmp_um;
     um_type *um_ptr = initialize_um_type(player_ptr, &tmp_um, m_idx, full);
     if (disturb_high) {
@@ -601,6 +616,7 @@ void update_monster(PlayerType *player_ptr, MONSTER_IDX m_idx, bool full)
     }
 
     decide_sight_invisible_monster(player_ptr, um_ptr, m_idx);
+    update_sleep_check(player_ptr->current_floor_ptr, m_idx, true);
     if (um_ptr->flag) {
         update_invisible_monster(player_ptr, um_ptr, m_idx);
     } else {
@@ -617,6 +633,36 @@ void update_monster(PlayerType *player_ptr, MONSTER_IDX m_idx, bool full)
     }
 }
 
+/*!
+ * @brief 感知範囲の外で感知状態が既に確定しているモンスターの更新を距離の更新だけで済ませる
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @param m_idx モンスターID
+ * @param full 距離更新を行うならtrue
+ * @param sensing_range テレパシー・視認を判定する距離の上限
+ * @return 済ませたらtrue、update_monster() による更新が必要ならfalse
+ * @details
+ * 感知範囲より遠いモンスターに対する update_monster() は、距離の更新・ESPフラグの解除・
+ * 視認状態をマーク状態に合わせることと、これらの変化に伴う再描画と妨害しか行わない.
+ * ESPも視界内フラグも立っておらず視認状態がマーク状態と一致していれば、距離以外は何も変わらない.
+ */
+static bool update_distant_monster(PlayerType *player_ptr, MONSTER_IDX m_idx, bool full, POSITION sensing_range)
+{
+    auto &monster = player_ptr->current_floor_ptr->m_list[m_idx];
+    if (monster.mflag.has_any_of({ MonsterTemporaryFlagType::ESP, MonsterTemporaryFlagType::VIEW }) || (monster.ml != monster.mflag2.has(MonsterConstantFlagType::MARK))) {
+        return false;
+    }
+
+    const auto distance = full ? calc_monster_distance(player_ptr, monster.fy, monster.fx) : monster.cdis;
+    if (distance <= sensing_range) {
+        return false;
+    }
+
+    monster.cdis = distance;
+    MonsterSpatialIndex::get_instance().update(*player_ptr->current_floor_ptr, m_idx);
+    update_sleep_check(player_ptr->current_floor_ptr, m_idx, false);
+    return true;
+}
+
 /*!
  * @param player_ptr プレイヤーへの参照ポインタ
  * @brief 単純に生存している全モンスターの更新処理を行う / This function simply updates all the (non-dead) monsters (see above).
@@ -626,12 +672,18 @@ void update_monster(PlayerType *player_ptr, MONSTER_IDX m_idx, bool full)
 void update_monsters(PlayerType *player_ptr, bool full)
 {
     auto *floor_ptr = player_ptr->current_floor_ptr;
+    const auto in_darkness = floor_ptr->get_dungeon_definition().flags.has(DungeonFeatureType::DARKNESS) && !player_ptr->see_nocto;
+    const auto sensing_range = in_darkness ? MAX_PLAYER_SIGHT / 2 : MAX_PLAYER_SIGHT;
     for (MONSTER_IDX i = 1; i < floor_ptr->m_max; i++) {
         auto *m_ptr = &floor_ptr->m_list[i];
         if (!m_ptr->is_valid()) {
             continue;
         }
 
+        if (update_distant_monster(player_ptr, i, full, sensing_range)) {
+            continue;
+        }
+
         update_monster(player_ptr, i, full);
     }
 }
@@ -6,6 +6,28 @@
 #include "system/item-entity.h"
 #include "system/player-type-definition.h"
 
+namespace {
+uint32_t item_knowledge_generation = 0;
+}
+
+/*!
+ * @brief アイテムの知識の世代を返す
+ * @details ベースアイテムの認識やアイテムの鑑定で進む.
+ * アイテムの表示を別途保持している処理が、作り直しの要否を判定するために使う.
+ */
+uint32_t get_item_knowledge_generation()
+{
+    return item_knowledge_generation;
+}
+
+/*!
+ * @brief アイテムの知識の世代を進める
+ */
+void update_item_knowledge_generation()
+{
+    item_knowledge_generation++;
+}
+
 /*!
  * @brief オブジェクトを＊鑑定＊済にする /
  * The player is now aware of the effects of the given object.
@@ -17,6 +39,9 @@ void object_aware(PlayerType *player_ptr, const ItemEntity *o_ptr)
     const bool is_already_awared = o_ptr->is_aware();
     auto &baseitem = o_ptr->get_baseitem();
     baseitem.aware = true;
+    if (!is_already_awared) {
+        update_item_knowledge_generation();
+    }
 
     // 以下、playrecordに記録しない場合はreturnする
     if (!record_ident) {
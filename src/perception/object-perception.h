@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+
 class ItemEntity;
 class PlayerType;
 void object_aware(PlayerType *player_ptr, const ItemEntity *o_ptr);
+uint32_t get_item_knowledge_generation();
+void update_item_knowledge_generation();
@@ -8,6 +8,7 @@
 #include "system/player-type-definition.h"
 #include "system/redrawing-flags-updater.h"
 #include "util/point-2d.h"
+#include <algorithm>
 #include <vector>
 
 /*
@@ -82,6 +83,7 @@ static bool update_view_aux(PlayerType *player_ptr, POSITION y, POSITION x, POSI
 
 /*
  * Calculate the viewable space
+ * 従来の帯の走査による視界の計算. update_view_octant() と結果を比べるために残している.
  *
  *  1: Process the player
  *  1a: The player is always (easily) viewable
@@ -98,7 +100,7 @@ static bool update_view_aux(PlayerType *player_ptr, POSITION y, POSITION x, POSI
  *  4c1: Each side aborts as soon as possible
  *  4c2: Each side tells the next strip how far it has to check
  */
-void update_view(PlayerType *player_ptr)
+void update_view_legacy(PlayerType *player_ptr)
 {
     // 前回プレイヤーから見えていた座標たちを格納する配列。
     std::vector<Pos2D> points;
@@ -134,6 +136,7 @@ void update_view(PlayerType *player_ptr)
     }
 
     floor_ptr->view_n = 0;
+    floor_ptr->view_version++;
     y = player_ptr->y;
     x = player_ptr->x;
     g_ptr = &floor_ptr->grid_array[y][x];
@@ -381,3 +384,219 @@ void update_view(PlayerType *player_ptr)
 
     RedrawingFlagsUpdater::get_instance().set_flag(StatusRecalculatingFlag::DELAY_VISIBILITY);
 }
+
+/*!
+ * @brief 帯の番号ごとの最大の長さを求める
+ * @param full 視界の最大距離
+ * @param over 帯を走査する範囲
+ * @return 帯の番号 (1～over/2) を添字とする長さの表
+ * @details 視界の最大距離は2通りしかないため、一度計算した表を使い回す.
+ */
+static const std::vector<int> &get_view_strip_lengths(int full, int over)
+{
+    static std::vector<int> lengths_full;
+    static std::vector<int> lengths_reduced;
+    auto &lengths = (full == MAX_PLAYER_SIGHT) ? lengths_full : lengths_reduced;
+    if (!lengths.empty()) {
+        return lengths;
+    }
+
+    lengths.resize(over / 2 + 1);
+    for (auto n = 1; n <= over / 2; n++) {
+        auto z = std::min(over - n - n, full - n);
+        while ((z + n + (n >> 1)) > full) {
+            z--;
+        }
+
+        lengths[n] = z;
+    }
+
+    return lengths;
+}
+
+/*!
+ * @brief 主軸に沿って壁に当たるまで視界に加える
+ * @return 壁に当たった距離 (当たらなければ最大距離+1)
+ */
+static int update_view_axis(FloorType *floor_ptr, POSITION y, POSITION x, int dy, int dx, int max_dist)
+{
+    int d;
+    for (d = 1; d <= max_dist; d++) {
+        const auto ty = y + dy * d;
+        const auto tx = x + dx * d;
+        auto &grid = floor_ptr->grid_array[ty][tx];
+        grid.info |= CAVE_XTRA;
+        cave_view_hack(floor_ptr, ty, tx);
+        if (!feat_supports_los(grid.feat)) {
+            break;
+        }
+    }
+
+    return d;
+}
+
+/*!
+ * @brief 八分円の帯を1本走査する
+ * @tparam PY 帯が伸びる主軸方向のy成分
+ * @tparam PX 帯が伸びる主軸方向のx成分
+ * @tparam SY 帯の始点が進む副軸方向のy成分
+ * @tparam SX 帯の始点が進む副軸方向のx成分
+ * @tparam SECONDARY_LIMIT_IS_WIDTH 副軸の範囲判定にフロアの幅を使うか (従来実装の判定をそのまま再現するため)
+ * @param n 帯の番号
+ * @param z 帯の最大の長さ
+ * @param limit この八分円で調べるべき距離. 走査後に次の帯のための値へ更新する.
+ * @details
+ * 帯上のマスの「斜め前」は主軸と副軸の両方を1つ戻したマス、「隣」は主軸だけを1つ戻したマスになる.
+ * 方向はコンパイル時に決まるため、従来の手で展開されたループと同等のコードになる.
+ */
+template <int PY, int PX, int SY, int SX, bool SECONDARY_LIMIT_IS_WIDTH>
+static void update_view_strip(PlayerType *player_ptr, POSITION y_max, POSITION x_max, int n, int z, int &limit)
+{
+    constexpr auto is_vertical = PY != 0;
+    constexpr auto primary_sign = PY + PX;
+    constexpr auto secondary_sign = SY + SX;
+    const auto y = player_ptr->y;
+    const auto x = player_ptr->x;
+    const auto primary = is_vertical ? y + PY * n : x + PX * n;
+    const auto primary_max = is_vertical ? y_max : x_max;
+    if ((primary_sign > 0) ? (primary >= primary_max) : (primary <= 0)) {
+        return;
+    }
+
+    const auto secondary = is_vertical ? x + SX * n : y + SY * n;
+    const auto secondary_max = SECONDARY_LIMIT_IS_WIDTH ? x_max : y_max;
+    if ((secondary_sign > 0) ? (secondary > secondary_max) : (secondary < 0)) {
+        return;
+    }
+
+    if (n >= limit) {
+        return;
+    }
+
+    const auto m = std::min(z, (primary_sign > 0) ? primary_max - primary : primary);
+    const auto base_y = y + (PY + SY) * n;
+    const auto base_x = x + (PX + SX) * n;
+    auto k = n;
+    for (auto d = 1; d <= m; d++) {
+        const auto ty = base_y + PY * d;
+        const auto tx = base_x + PX * d;
+        if (!update_view_aux(player_ptr, ty, tx, ty - PY - SY, tx - PX - SX, ty - PY, tx - PX)) {
+            k = n + d;
+            continue;
+        }
+
+        if (n + d >= limit) {
+            break;
+        }
+    }
+
+    limit = k + 1;
+}
+
+/*!
+ * @brief 八分円ごとの帯の走査を用いて視界を計算する
+ * @details
+ * update_view_legacy() の帯の走査を、八分円の方向ごとにテンプレート化した走査と帯の長さの表から組み立て直したもの.
+ * 南東・南西・北東・北西は縦方向、東南・東北・西南・西北は横方向に帯が伸び、東南の副軸(y座標)だけは従来通りフロアの幅と比較する.
+ * 視界に入るマスとその登録順は従来の実装と完全に一致する.
+ */
+void update_view_octant(PlayerType *player_ptr)
+{
+    // 前回プレイヤーから見えていた座標たち. 毎回の確保を避けるため使い回す.
+    static std::vector<Pos2D> points;
+    points.clear();
+
+    auto *floor_ptr = player_ptr->current_floor_ptr;
+    const POSITION y_max = floor_ptr->height - 1;
+    const POSITION x_max = floor_ptr->width - 1;
+    const auto is_reduced = view_reduce_view && !floor_ptr->dun_level;
+    const auto full = is_reduced ? MAX_PLAYER_SIGHT / 2 : MAX_PLAYER_SIGHT;
+    const auto over = is_reduced ? MAX_PLAYER_SIGHT * 3 / 4 : MAX_PLAYER_SIGHT * 3 / 2;
+    for (auto n = 0; n < floor_ptr->view_n; n++) {
+        const auto y = floor_ptr->view_y[n];
+        const auto x = floor_ptr->view_x[n];
+        auto &grid = floor_ptr->grid_array[y][x];
+        grid.info &= ~(CAVE_VIEW);
+        grid.info |= CAVE_TEMP;
+        points.emplace_back(y, x);
+    }
+
+    floor_ptr->view_n = 0;
+    floor_ptr->view_version++;
+    const auto y = player_ptr->y;
+    const auto x = player_ptr->x;
+    floor_ptr->grid_array[y][x].info |= CAVE_XTRA;
+    cave_view_hack(floor_ptr, y, x);
+
+    const auto diagonal = full * 2 / 3;
+    update_view_axis(floor_ptr, y, x, 1, 1, diagonal);
+    update_view_axis(floor_ptr, y, x, 1, -1, diagonal);
+    update_view_axis(floor_ptr, y, x, -1, 1, diagonal);
+    update_view_axis(floor_ptr, y, x, -1, -1, diagonal);
+    const auto south = update_view_axis(floor_ptr, y, x, 1, 0, full);
+    const auto north = update_view_axis(floor_ptr, y, x, -1, 0, full);
+    const auto east = update_view_axis(floor_ptr, y, x, 0, 1, full);
+    const auto west = update_view_axis(floor_ptr, y, x, 0, -1, full);
+
+    // 各八分円で次の帯が調べるべき距離. 初期値は主軸上で壁に当たった距離.
+    auto se = south;
+    auto sw = south;
+    auto ne = north;
+    auto nw = north;
+    auto es = east;
+    auto en = east;
+    auto ws = west;
+    auto wn = west;
+    const auto &strip_lengths = get_view_strip_lengths(full, over);
+    for (auto n = 1; n <= over / 2; n++) {
+        const auto z = strip_lengths[n];
+        update_view_strip<1, 0, 0, 1, true>(player_ptr, y_max, x_max, n, z, se);
+        update_view_strip<1, 0, 0, -1, true>(player_ptr, y_max, x_max, n, z, sw);
+        update_view_strip<-1, 0, 0, 1, true>(player_ptr, y_max, x_max, n, z, ne);
+        update_view_strip<-1, 0, 0, -1, true>(player_ptr, y_max, x_max, n, z, nw);
+        update_view_strip<0, 1, 1, 0, true>(player_ptr, y_max, x_max, n, z, es);
+        update_view_strip<0, 1, -1, 0, false>(player_ptr, y_max, x_max, n, z, en);
+        update_view_strip<0, -1, 1, 0, false>(player_ptr, y_max, x_max, n, z, ws);
+        update_view_strip<0, -1, -1, 0, false>(player_ptr, y_max, x_max, n, z, wn);
+        if (std::max({ se, sw, ne, nw, es, en, ws, wn }) <= n + 1) {
+            break; // 全ての八分円が壁で塞がれた
+        }
+    }
+
+    for (auto n = 0; n < floor_ptr->view_n; n++) {
+        const auto vy = floor_ptr->view_y[n];
+        const auto vx = floor_ptr->view_x[n];
+        auto &grid = floor_ptr->grid_array[vy][vx];
+        grid.info &= ~(CAVE_XTRA);
+        if (grid.info & CAVE_TEMP) {
+            continue;
+        }
+
+        cave_note_and_redraw_later(floor_ptr, vy, vx);
+    }
+
+    for (const auto &[py, px] : points) {
+        auto &grid = floor_ptr->grid_array[py][px];
+        grid.info &= ~(CAVE_TEMP);
+        if (grid.info & CAVE_VIEW) {
+            continue;
+        }
+
+        cave_redraw_later(floor_ptr, py, px);
+    }
+
+    RedrawingFlagsUpdater::get_instance().set_flag(StatusRecalculatingFlag::DELAY_VISIBILITY);
+}
+
+/*!
+ * @brief 視界を計算する
+ * @details --enable-legacy-view を指定した時は従来の帯の走査を使う.
+ */
+void update_view(PlayerType *player_ptr)
+{
+#ifdef USE_LEGACY_VIEW
+    update_view_legacy(player_ptr);
+#else
+    update_view_octant(player_ptr);
+#endif
+}
@@ -2,3 +2,5 @@
 
 class PlayerType;
 void update_view(PlayerType *player_ptr);
+void update_view_legacy(PlayerType *player_ptr);
+void update_view_octant(PlayerType *player_ptr);
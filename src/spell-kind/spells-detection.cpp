@@ -12,6 +12,7 @@
 #include "monster-race/race-flags3.h"
 #include "monster/monster-flag-types.h"
 #include "monster/monster-info.h"
+#include "monster/monster-spatial-index.h"
 #include "monster/monster-status.h"
 #include "monster/monster-update.h"
 #include "object/object-mark-types.h"
@@ -351,18 +352,9 @@ bool detect_monsters_normal(PlayerType *player_ptr, POSITION range)
     }
 
     bool flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : MonsterSpatialIndex::get_instance().collect_within_distance(floor, player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
 
         if (!(r_ptr->flags2 & RF2_INVISIBLE) || player_ptr->see_inv) {
             m_ptr->mflag2.set({ MonsterConstantFlagType::MARK, MonsterConstantFlagType::SHOW });
@@ -396,21 +388,10 @@ bool detect_monsters_invis(PlayerType *player_ptr, POSITION range)
 
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : MonsterSpatialIndex::get_instance().collect_within_distance(floor, player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         auto *r_ptr = &m_ptr->get_monrace();
 
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
-
         if (r_ptr->flags2 & RF2_INVISIBLE) {
             if (player_ptr->monster_race_idx == m_ptr->r_idx) {
                 rfu.set_flag(SubWindowRedrawingFlag::MONSTER_LORE);
@@ -447,19 +428,9 @@ bool detect_monsters_evil(PlayerType *player_ptr, POSITION range)
 
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : MonsterSpatialIndex::get_instance().collect_within_distance(floor, player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
 
         if (r_ptr->kind_flags.has(MonsterKindType::EVIL)) {
             if (m_ptr->is_original_ap()) {
@@ -497,17 +468,8 @@ bool detect_monsters_nonliving(PlayerType *player_ptr, POSITION range)
 
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : MonsterSpatialIndex::get_instance().collect_within_distance(floor, player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
 
         if (!m_ptr->has_living_flag()) {
             if (player_ptr->monster_race_idx == m_ptr->r_idx) {
@@ -542,19 +504,9 @@ bool detect_monsters_mind(PlayerType *player_ptr, POSITION range)
 
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : MonsterSpatialIndex::get_instance().collect_within_distance(floor, player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
 
         if (!(r_ptr->flags2 & RF2_EMPTY_MIND)) {
             if (player_ptr->monster_race_idx == m_ptr->r_idx) {
@@ -590,19 +542,9 @@ bool detect_monsters_string(PlayerType *player_ptr, POSITION range, concptr Matc
 
     auto &rfu = RedrawingFlagsUpdater::get_instance();
     auto flag = false;
-    for (MONSTER_IDX i = 1; i < floor.m_max; i++) {
+    for (const auto i : MonsterSpatialIndex::get_instance().collect_within_distance(floor, player_ptr->get_position(), range)) {
         auto *m_ptr = &floor.m_list[i];
         auto *r_ptr = &m_ptr->get_monrace();
-        if (!m_ptr->is_valid()) {
-            continue;
-        }
-
-        POSITION y = m_ptr->fy;
-        POSITION x = m_ptr->fx;
-
-        if (distance(player_ptr->y, player_ptr->x, y, x) > range) {
-            continue;
-        }
 
         if (angband_strchr(Match, r_ptr->d_char)) {
             if (player_ptr->monster_race_idx == m_ptr->r_idx) {
@@ -15,6 +15,8 @@
 #include "system/player-type-definition.h"
 #include "target/projection-path-calculator.h"
 #include "util/bit-flags-calculator.h"
+#include <algorithm>
+#include <vector>
 
 /*
  * Find the distance from (x, y) to a line.
@@ -195,6 +197,108 @@ bool in_disintegration_range(FloorType *floor_ptr, POSITION y1, POSITION x1, POS
     return true;
 }
 
+namespace {
+/*!
+ * @brief 爆発の中心からの相対位置
+ */
+struct area_offset {
+    int8_t y;
+    int8_t x;
+};
+
+/*!
+ * @brief 爆発範囲の相対位置一覧
+ * @details 中心からの距離、Y座標、X座標の昇順に並べてある.
+ * 正方形を距離ごとに走査していた頃と同じ順序で、範囲内のマスを1度ずつ辿れる.
+ */
+struct area_offset_table {
+    int radius = -1; //!< 一覧に含まれる距離の上限
+    std::vector<area_offset> offsets{};
+    std::vector<int> ends{}; //!< 距離ごとの、その距離以下のマスの数
+};
+}
+
+/*!
+ * @brief 指定した半径まで含む爆発範囲の相対位置一覧を得る
+ * @param rad 半径
+ * @return 相対位置一覧への参照
+ * @details 距離は必ず縦横の差の大きい方以上になるため、半径の正方形から距離が半径以内のものを選べば足りる.
+ */
+static const area_offset_table &get_area_offsets(int rad)
+{
+    static area_offset_table table;
+    if (rad <= table.radius) {
+        return table;
+    }
+
+    table.radius = std::max(rad, 32);
+    table.offsets.clear();
+    std::vector<std::pair<int, area_offset>> sorted;
+    for (auto dy = -table.radius; dy <= table.radius; dy++) {
+        for (auto dx = -table.radius; dx <= table.radius; dx++) {
+            const auto dist = distance(0, 0, dy, dx);
+            if (dist <= table.radius) {
+                sorted.push_back({ dist, { static_cast<int8_t>(dy), static_cast<int8_t>(dx) } });
+            }
+        }
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    table.ends.assign(table.radius + 1, 0);
+    for (const auto &[dist, offset] : sorted) {
+        table.offsets.push_back(offset);
+        table.ends[dist] = static_cast<int>(table.offsets.size());
+    }
+
+    return table;
+}
+
+/*!
+ * @brief 爆発の中心から指定のマスまで効果が届くか
+ * @details 閃光は光を通さない地形で、分解は永久壁で、それ以外は投射を通さない地形で止まる.
+ */
+static bool is_in_explosion_area(PlayerType *player_ptr, POSITION by, POSITION bx, POSITION y, POSITION x, AttributeType typ)
+{
+    switch (typ) {
+    case AttributeType::LITE:
+    case AttributeType::LITE_WEAK:
+        return los(player_ptr, by, bx, y, x);
+    case AttributeType::DISINTEGRATE:
+        return in_disintegration_range(player_ptr->current_floor_ptr, by, bx, y, x);
+    default:
+        return projectable(player_ptr, by, bx, y, x);
+    }
+}
+
+/*
+ * ball shape
+ */
+void ball_shape(PlayerType *player_ptr, int *pgrids, POSITION *gx, POSITION *gy, POSITION *gm, POSITION rad, POSITION by, POSITION bx, AttributeType typ)
+{
+    if (rad < 0) {
+        return;
+    }
+
+    auto *floor_ptr = player_ptr->current_floor_ptr;
+    const auto &table = get_area_offsets(rad);
+    auto i = 0;
+    for (auto dist = 0; dist <= rad; dist++) {
+        for (; i < table.ends[dist]; i++) {
+            const auto y = by + table.offsets[i].y;
+            const auto x = bx + table.offsets[i].x;
+            if (!in_bounds2(floor_ptr, y, x) || !is_in_explosion_area(player_ptr, by, bx, y, x, typ)) {
+                continue;
+            }
+
+            gy[*pgrids] = y;
+            gx[*pgrids] = x;
+            (*pgrids)++;
+        }
+
+        gm[dist + 1] = *pgrids;
+    }
+}
+
 /*
  * breath shape
  */
@@ -205,11 +309,11 @@ void breath_shape(PlayerType *player_ptr, const projection_path &path, int dist,
     int brad = 0;
     int brev = rad * rad / dist;
     int bdis = 0;
-    int cdis;
     int path_n = 0;
     int mdis = distance(y1, x1, y2, x2) + rad;
 
     auto *floor_ptr = player_ptr->current_floor_ptr;
+    const auto &table = get_area_offsets(rad);
     while (bdis <= mdis) {
         if ((0 < dist) && (path_n < dist)) {
             const auto &[ny, nx] = path[path_n];
@@ -223,46 +327,22 @@ void breath_shape(PlayerType *player_ptr, const projection_path &path, int dist,
         }
 
         /* Travel from center outward */
-        for (cdis = 0; cdis <= brad; cdis++) {
-            for (POSITION y = by - cdis; y <= by + cdis; y++) {
-                for (POSITION x = bx - cdis; x <= bx + cdis; x++) {
-                    if (!in_bounds(floor_ptr, y, x)) {
-                        continue;
-                    }
-                    if (distance(y1, x1, y, x) != bdis) {
-                        continue;
-                    }
-                    if (distance(by, bx, y, x) != cdis) {
-                        continue;
-                    }
-
-                    switch (typ) {
-                    case AttributeType::LITE:
-                    case AttributeType::LITE_WEAK:
-                        /* Lights are stopped by opaque terrains */
-                        if (!los(player_ptr, by, bx, y, x)) {
-                            continue;
-                        }
-                        break;
-                    case AttributeType::DISINTEGRATE:
-                        /* Disintegration are stopped only by perma-walls */
-                        if (!in_disintegration_range(floor_ptr, by, bx, y, x)) {
-                            continue;
-                        }
-                        break;
-                    default:
-                        /* Ball explosions are stopped by walls */
-                        if (!projectable(player_ptr, by, bx, y, x)) {
-                            continue;
-                        }
-                        break;
-                    }
-
-                    gy[*pgrids] = y;
-                    gx[*pgrids] = x;
-                    (*pgrids)++;
-                }
+        for (auto i = 0; i < table.ends[brad]; i++) {
+            const auto y = by + table.offsets[i].y;
+            const auto x = bx + table.offsets[i].x;
+            if (!in_bounds(floor_ptr, y, x)) {
+                continue;
+            }
+            if (distance(y1, x1, y, x) != bdis) {
+                continue;
             }
+            if (!is_in_explosion_area(player_ptr, by, bx, y, x, typ)) {
+                continue;
+            }
+
+            gy[*pgrids] = y;
+            gx[*pgrids] = x;
+            (*pgrids)++;
         }
 
         gm[bdis + 1] = *pgrids;
@@ -57,13 +57,18 @@ public:
     std::vector<ItemEntity> o_list; /*!< The array of dungeon items [max_o_idx] */
     OBJECT_IDX o_max = 0; /* Number of allocated objects */
     OBJECT_IDX o_cnt = 0; /* Number of live objects */
+    std::vector<OBJECT_IDX> o_free_list{}; //!< 空きになったアイテム配列の添字 (o_pop() で再利用する)
 
     std::vector<MonsterEntity> m_list; /*!< The array of dungeon monsters [max_m_idx] */
     MONSTER_IDX m_max = 0; /* Number of allocated monsters */
     MONSTER_IDX m_cnt = 0; /* Number of live monsters */
+    std::vector<MONSTER_IDX> m_free_list{}; //!< 空きになったモンスター配列の添字 (m_pop() で再利用する)
 
     std::vector<int16_t> mproc_list[MAX_MTIMED]{}; /*!< The array to process dungeon monsters[max_m_idx] */
     int16_t mproc_max[MAX_MTIMED]{}; /*!< Number of monsters to be processed */
+    std::vector<int16_t> mproc_index[MAX_MTIMED]{}; //!< モンスターIDごとの mproc_list 上の位置 (mproc_list と突き合わせて使う)
+    std::vector<uint64_t> sleep_check_bits{}; //!< 起床判定が必要になり得る睡眠中モンスターの mproc_list[MTIMED_CSLEEP] 上の位置
+    std::vector<POSITION> sleep_check_ranges{}; //!< モンスターIDごとの起床判定を行う距離の上限
 
     POSITION_IDX lite_n = 0; //!< Array of grids lit by player lite
     std::array<POSITION, LITE_MAX> lite_y{};
@@ -74,6 +79,7 @@ public:
     std::array<POSITION, MON_LITE_MAX> mon_lite_x{};
 
     POSITION_IDX view_n = 0; //!< Array of grids viewable to the player
+    uint32_t view_version = 0; //!< 視界 (CAVE_VIEW) を更新した回数
     std::array<POSITION, VIEW_MAX> view_y{};
     std::array<POSITION, VIEW_MAX> view_x{};
 
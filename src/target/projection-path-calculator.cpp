@@ -2,6 +2,7 @@
 #include "effect/effect-characteristics.h"
 #include "effect/spells-effect-util.h"
 #include "floor/cave.h"
+#include "floor/line-of-sight-cache.h"
 #include "grid/feature-flag-types.h"
 #include "spell-class/spells-mirror-master.h"
 #include "system/angband-system.h"
@@ -9,9 +10,11 @@
 #include "system/grid-type-definition.h"
 #include "system/player-type-definition.h"
 #include "util/bit-flags-calculator.h"
+#include <cstdlib>
 
 struct projection_path_type {
-    std::vector<std::pair<int, int>> *position;
+    std::pair<int, int> *position;
+    int position_num;
     POSITION range;
     BIT_FLAGS flag;
     POSITION y1;
@@ -31,14 +34,14 @@ struct projection_path_type {
     int k;
 };
 
-std::vector<std::pair<int, int>>::const_iterator projection_path::begin() const
+projection_path::const_iterator projection_path::begin() const
 {
     return this->position.cbegin();
 }
 
-std::vector<std::pair<int, int>>::const_iterator projection_path::end() const
+projection_path::const_iterator projection_path::end() const
 {
-    return this->position.cend();
+    return this->position.cbegin() + this->position_num;
 }
 
 const std::pair<int, int> &projection_path::front() const
@@ -48,7 +51,7 @@ const std::pair<int, int> &projection_path::front() const
 
 const std::pair<int, int> &projection_path::back() const
 {
-    return this->position.back();
+    return this->position[this->position_num - 1];
 }
 
 const std::pair<int, int> &projection_path::operator[](int num) const
@@ -58,13 +61,14 @@ const std::pair<int, int> &projection_path::operator[](int num) const
 
 int projection_path::path_num() const
 {
-    return static_cast<int>(this->position.size());
+    return this->position_num;
 }
 
 static projection_path_type *initialize_projection_path_type(
-    projection_path_type *pp_ptr, std::vector<std::pair<int, int>> *position, POSITION range, BIT_FLAGS flag, POSITION y1, POSITION x1, POSITION y2, POSITION x2)
+    projection_path_type *pp_ptr, std::pair<int, int> *position, POSITION range, BIT_FLAGS flag, POSITION y1, POSITION x1, POSITION y2, POSITION x2)
 {
     pp_ptr->position = position;
+    pp_ptr->position_num = 0;
     pp_ptr->range = range;
     pp_ptr->flag = flag;
     pp_ptr->y1 = y1;
@@ -103,27 +107,27 @@ static bool project_stop(PlayerType *player_ptr, projection_path_type *pp_ptr)
     }
 
     if (any_bits(pp_ptr->flag, PROJECT_DISI)) {
-        if (!pp_ptr->position->empty() && cave_stop_disintegration(floor_ptr, pos.y, pos.x)) {
+        if ((pp_ptr->position_num > 0) && cave_stop_disintegration(floor_ptr, pos.y, pos.x)) {
             return true;
         }
     } else if (any_bits(pp_ptr->flag, PROJECT_LOS)) {
-        if (!pp_ptr->position->empty() && !cave_los_bold(floor_ptr, pos.y, pos.x)) {
+        if ((pp_ptr->position_num > 0) && !cave_los_bold(floor_ptr, pos.y, pos.x)) {
             return true;
         }
     } else if (none_bits(pp_ptr->flag, PROJECT_PATH)) {
-        if (!pp_ptr->position->empty() && !cave_has_flag_bold(floor_ptr, pos.y, pos.x, TerrainCharacteristics::PROJECT)) {
+        if ((pp_ptr->position_num > 0) && !cave_has_flag_bold(floor_ptr, pos.y, pos.x, TerrainCharacteristics::PROJECT)) {
             return true;
         }
     }
 
     const auto &grid = floor_ptr->get_grid(pos);
     if (any_bits(pp_ptr->flag, PROJECT_MIRROR)) {
-        if (!pp_ptr->position->empty() && grid.is_mirror()) {
+        if ((pp_ptr->position_num > 0) && grid.is_mirror()) {
             return true;
         }
     }
 
-    if (any_bits(pp_ptr->flag, PROJECT_STOP) && !pp_ptr->position->empty() && (player_ptr->is_located_at(pos) || grid.m_idx != 0)) {
+    if (any_bits(pp_ptr->flag, PROJECT_STOP) && (pp_ptr->position_num > 0) && (player_ptr->is_located_at(pos) || grid.m_idx != 0)) {
         return true;
     }
 
@@ -155,11 +159,21 @@ static void calc_frac(projection_path_type *pp_ptr, bool is_vertical)
     pp_ptr->k++;
 }
 
+/*!
+ * @brief 経路にマスを追加する
+ * @return 経路の長さが上限に達したらFALSE
+ * @details 経路はフロアの外周で必ず止まるため、上限に達するのは異常な呼び出しの場合のみ.
+ */
+static bool add_projection_position(projection_path_type *pp_ptr)
+{
+    pp_ptr->position[pp_ptr->position_num++] = { pp_ptr->y, pp_ptr->x };
+    return pp_ptr->position_num < projection_path::MAX_PATH_LENGTH;
+}
+
 static void calc_projection_to_target(PlayerType *player_ptr, projection_path_type *pp_ptr, bool is_vertical)
 {
-    while (true) {
-        pp_ptr->position->emplace_back(pp_ptr->y, pp_ptr->x);
-        if (static_cast<int>(pp_ptr->position->size()) + pp_ptr->k / 2 >= pp_ptr->range) {
+    while (add_projection_position(pp_ptr)) {
+        if (pp_ptr->position_num + pp_ptr->k / 2 >= pp_ptr->range) {
             break;
         }
 
@@ -176,12 +190,8 @@ static void calc_projection_to_target(PlayerType *player_ptr, projection_path_ty
     }
 }
 
-static bool calc_vertical_projection(PlayerType *player_ptr, projection_path_type *pp_ptr)
+static void start_vertical_projection(projection_path_type *pp_ptr)
 {
-    if (pp_ptr->ay <= pp_ptr->ax) {
-        return false;
-    }
-
     pp_ptr->m = pp_ptr->ax * pp_ptr->ax * 2;
     pp_ptr->y = pp_ptr->y1 + pp_ptr->sy;
     pp_ptr->x = pp_ptr->x1;
@@ -191,17 +201,10 @@ static bool calc_vertical_projection(PlayerType *player_ptr, projection_path_typ
         pp_ptr->frac -= pp_ptr->full;
         pp_ptr->k++;
     }
-
-    calc_projection_to_target(player_ptr, pp_ptr, true);
-    return true;
 }
 
-static bool calc_horizontal_projection(PlayerType *player_ptr, projection_path_type *pp_ptr)
+static void start_horizontal_projection(projection_path_type *pp_ptr)
 {
-    if (pp_ptr->ax <= pp_ptr->ay) {
-        return false;
-    }
-
     pp_ptr->m = pp_ptr->ay * pp_ptr->ay * 2;
     pp_ptr->y = pp_ptr->y1;
     pp_ptr->x = pp_ptr->x1 + pp_ptr->sx;
@@ -211,16 +214,34 @@ static bool calc_horizontal_projection(PlayerType *player_ptr, projection_path_t
         pp_ptr->frac -= pp_ptr->full;
         pp_ptr->k++;
     }
+}
 
+static bool calc_vertical_projection(PlayerType *player_ptr, projection_path_type *pp_ptr)
+{
+    if (pp_ptr->ay <= pp_ptr->ax) {
+        return false;
+    }
+
+    start_vertical_projection(pp_ptr);
+    calc_projection_to_target(player_ptr, pp_ptr, true);
+    return true;
+}
+
+static bool calc_horizontal_projection(PlayerType *player_ptr, projection_path_type *pp_ptr)
+{
+    if (pp_ptr->ax <= pp_ptr->ay) {
+        return false;
+    }
+
+    start_horizontal_projection(pp_ptr);
     calc_projection_to_target(player_ptr, pp_ptr, false);
     return true;
 }
 
 static void calc_projection_others(PlayerType *player_ptr, projection_path_type *pp_ptr)
 {
-    while (true) {
-        pp_ptr->position->emplace_back(pp_ptr->y, pp_ptr->x);
-        if (static_cast<int>(pp_ptr->position->size()) * 3 / 2 >= pp_ptr->range) {
+    while (add_projection_position(pp_ptr)) {
+        if (pp_ptr->position_num * 3 / 2 >= pp_ptr->range) {
             break;
         }
 
@@ -233,6 +254,87 @@ static void calc_projection_others(PlayerType *player_ptr, projection_path_type
     }
 }
 
+/*!
+ * @brief 障害物のないフロアでの投射経路を求める
+ * @param dy 終点の始点からの相対Y座標
+ * @param dx 終点の始点からの相対X座標
+ * @param steps 求めた経路を追加する配列
+ * @details 停止条件を除けば projection_path と同じマスを同じ順に辿り、射程の判定に使う距離が
+ * PROJECTION_TEMPLATE_RANGE 以上になったマスまでを返す. 終点を過ぎても同じ向きに進み続ける.
+ */
+static void calc_projection_path_template(POSITION dy, POSITION dx, std::vector<projection_path_step> &steps)
+{
+    projection_path_type tmp_projection_path;
+    auto *pp_ptr = initialize_projection_path_type(&tmp_projection_path, nullptr, 0, 0, 0, 0, dy, dx);
+    set_asxy(pp_ptr);
+    pp_ptr->half = pp_ptr->ay * pp_ptr->ax;
+    pp_ptr->full = pp_ptr->half << 1;
+    pp_ptr->k = 0;
+    const auto is_vertical = pp_ptr->ay > pp_ptr->ax;
+    const auto is_horizontal = pp_ptr->ax > pp_ptr->ay;
+    if (is_vertical) {
+        start_vertical_projection(pp_ptr);
+    } else if (is_horizontal) {
+        start_horizontal_projection(pp_ptr);
+    } else {
+        pp_ptr->y = pp_ptr->sy;
+        pp_ptr->x = pp_ptr->sx;
+    }
+
+    for (auto num = 1; true; num++) {
+        const auto distance = (is_vertical || is_horizontal) ? num + pp_ptr->k / 2 : num * 3 / 2;
+        steps.push_back({ static_cast<int8_t>(pp_ptr->y), static_cast<int8_t>(pp_ptr->x), static_cast<int16_t>(distance) });
+        if (distance >= PROJECTION_TEMPLATE_RANGE) {
+            return;
+        }
+
+        if (is_vertical) {
+            calc_frac(pp_ptr, true);
+            pp_ptr->y += pp_ptr->sy;
+        } else if (is_horizontal) {
+            calc_frac(pp_ptr, false);
+            pp_ptr->x += pp_ptr->sx;
+        } else {
+            pp_ptr->y += pp_ptr->sy;
+            pp_ptr->x += pp_ptr->sx;
+        }
+    }
+}
+
+/*!
+ * @brief 始点からの相対位置ごとの投射経路の雛形を返す
+ * @param dy 終点の始点からの相対Y座標
+ * @param dx 終点の始点からの相対X座標
+ * @return 経路の雛形. 相対位置が PROJECTION_TEMPLATE_RANGE を超える場合や始点と終点が同じ場合は空
+ * @details 全ての相対位置の雛形を初回の呼び出し時にまとめて計算する.
+ */
+std::span<const projection_path_step> get_projection_path_template(POSITION dy, POSITION dx)
+{
+    constexpr auto size = PROJECTION_TEMPLATE_RANGE * 2 + 1;
+    static std::vector<projection_path_step> steps;
+    static std::vector<uint32_t> starts;
+    if (starts.empty()) {
+        starts.reserve(size * size + 1);
+        for (auto ty = -PROJECTION_TEMPLATE_RANGE; ty <= PROJECTION_TEMPLATE_RANGE; ty++) {
+            for (auto tx = -PROJECTION_TEMPLATE_RANGE; tx <= PROJECTION_TEMPLATE_RANGE; tx++) {
+                starts.push_back(static_cast<uint32_t>(steps.size()));
+                if ((ty != 0) || (tx != 0)) {
+                    calc_projection_path_template(ty, tx, steps);
+                }
+            }
+        }
+
+        starts.push_back(static_cast<uint32_t>(steps.size()));
+    }
+
+    if ((std::abs(dy) > PROJECTION_TEMPLATE_RANGE) || (std::abs(dx) > PROJECTION_TEMPLATE_RANGE)) {
+        return {};
+    }
+
+    const auto index = (dy + PROJECTION_TEMPLATE_RANGE) * size + (dx + PROJECTION_TEMPLATE_RANGE);
+    return std::span<const projection_path_step>(steps.data() + starts[index], starts[index + 1] - starts[index]);
+}
+
 /*!
  * @brief 始点から終点への直線経路を返す /
  * Determine the path taken by a projection.
@@ -244,32 +346,50 @@ static void calc_projection_others(PlayerType *player_ptr, projection_path_type
  * @param x2 終点X座標
  * @param flag フラグID
  * @return リストの長さ
+ * @details 射程が雛形の範囲に収まる場合は、雛形を平行移動しながら停止条件だけを調べる.
  */
 projection_path::projection_path(PlayerType *player_ptr, POSITION range, POSITION y1, POSITION x1, POSITION y2, POSITION x2, BIT_FLAGS flag)
 {
-    this->position.clear();
     if ((x1 == x2) && (y1 == y2)) {
         return;
     }
 
     projection_path_type tmp_projection_path;
-    auto *pp_ptr = initialize_projection_path_type(&tmp_projection_path, &this->position, range, flag, y1, x1, y2, x2);
+    auto *pp_ptr = initialize_projection_path_type(&tmp_projection_path, this->position.data(), range, flag, y1, x1, y2, x2);
+    const auto steps = get_projection_path_template(y2 - y1, x2 - x1);
+    if (!steps.empty() && (range <= PROJECTION_TEMPLATE_RANGE)) {
+        for (const auto &step : steps) {
+            pp_ptr->y = y1 + step.y;
+            pp_ptr->x = x1 + step.x;
+            add_projection_position(pp_ptr);
+            if ((step.distance >= range) || project_stop(player_ptr, pp_ptr)) {
+                break;
+            }
+        }
+
+        this->position_num = pp_ptr->position_num;
+        return;
+    }
+
     set_asxy(pp_ptr);
     pp_ptr->half = pp_ptr->ay * pp_ptr->ax;
     pp_ptr->full = pp_ptr->half << 1;
     pp_ptr->k = 0;
 
     if (calc_vertical_projection(player_ptr, pp_ptr)) {
+        this->position_num = pp_ptr->position_num;
         return;
     }
 
     if (calc_horizontal_projection(player_ptr, pp_ptr)) {
+        this->position_num = pp_ptr->position_num;
         return;
     }
 
     pp_ptr->y = y1 + pp_ptr->sy;
     pp_ptr->x = x1 + pp_ptr->sx;
     calc_projection_others(player_ptr, pp_ptr);
+    this->position_num = pp_ptr->position_num;
 }
 
 /*
@@ -280,7 +400,13 @@ projection_path::projection_path(PlayerType *player_ptr, POSITION range, POSITIO
  */
 bool projectable(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION x2)
 {
-    projection_path grid_g(player_ptr, (project_length ? project_length : AngbandSystem::get_instance().get_max_range()), y1, x1, y2, x2, 0);
+    const auto range = project_length ? project_length : AngbandSystem::get_instance().get_max_range();
+    const auto cached = LineOfSightCache::get_instance().projectable(*player_ptr->current_floor_ptr, { y1, x1 }, { y2, x2 }, range);
+    if (cached) {
+        return *cached;
+    }
+
+    projection_path grid_g(player_ptr, range, y1, x1, y2, x2, 0);
     if (grid_g.path_num() == 0) {
         return true;
     }
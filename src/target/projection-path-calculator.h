@@ -1,14 +1,23 @@
 #pragma once
 
+#include "floor/floor-base-definitions.h"
 #include "system/angband.h"
+#include <array>
+#include <cstdint>
+#include <span>
 #include <utility>
-#include <vector>
 
 // @todo pairをPos2Dとして再定義する.
 class PlayerType;
 class projection_path {
 public:
-    using const_iterator = std::vector<std::pair<int, int>>::const_iterator;
+    /*!
+     * @brief 経路の最大長
+     * @details 経路は1マス進むごとに長軸方向へ必ず1マス進み、フロアの外周で止まるためフロアの幅を超えない.
+     */
+    static constexpr int MAX_PATH_LENGTH = MAX_WID;
+
+    using const_iterator = std::array<std::pair<int, int>, MAX_PATH_LENGTH>::const_iterator;
 
     projection_path(PlayerType *player_ptr, POSITION range, POSITION y1, POSITION x1, POSITION y2, POSITION x2, BIT_FLAGS flag);
     const_iterator begin() const;
@@ -19,8 +28,25 @@ public:
     int path_num() const;
 
 private:
-    std::vector<std::pair<int, int>> position;
+    std::array<std::pair<int, int>, MAX_PATH_LENGTH> position; //!< 経路の座標. 毎回のメモリ確保を避けるため固定長で持つ
+    int position_num = 0;
 };
+
+/*!
+ * @brief 投射経路の雛形を用意する相対距離の上限 (闘技場の射程に合わせる)
+ */
+constexpr int PROJECTION_TEMPLATE_RANGE = 36;
+
+/*!
+ * @brief 投射経路の雛形の1マス
+ */
+struct projection_path_step {
+    int8_t y; //!< 始点からの相対Y座標
+    int8_t x; //!< 始点からの相対X座標
+    int16_t distance; //!< このマスで射程の判定に使う距離
+};
+
 bool projectable(PlayerType *player_ptr, POSITION y1, POSITION x1, POSITION y2, POSITION x2);
+std::span<const projection_path_step> get_projection_path_template(POSITION dy, POSITION dx);
 POSITION get_grid_y(uint16_t grid);
 POSITION get_grid_x(uint16_t grid);
@@ -14,21 +14,8 @@
 #include "term/gameterm.h"
 #include "term/term-color-types.h"
 #include "term/z-virt.h"
-
-/* Special flags in the attr data */
-#define AF_BIGTILE2 0xf0
-#define AF_TILE1 0x80
-
-#ifdef JP
-/*
- * 全角文字対応。
- * 属性に全角文字の1バイト目、2バイト目も記憶。
- * By FIRST
- */
-#define AF_KANJI1 0x10
-#define AF_KANJI2 0x20
-#define AF_KANJIC 0x0f
-#endif
+#include <cstdint>
+#include <cstring>
 
 /* The current "term" */
 term_type *game_term = nullptr;
@@ -114,10 +101,10 @@ TermCenteredOffsetSetter::~TermCenteredOffsetSetter()
  * Initialize a "term_win" (using the given window size)
  */
 term_win::term_win(TERM_LEN w, TERM_LEN h)
-    : a(h, std::vector<TERM_COLOR>(w))
-    , c(h, std::vector<char>(w))
-    , ta(h, std::vector<TERM_COLOR>(w))
-    , tc(h, std::vector<char>(w))
+    : a(w, h)
+    , c(w, h)
+    , ta(w, h)
+    , tc(w, h)
 {
 }
 
@@ -141,21 +128,14 @@ std::unique_ptr<term_win> term_win::clone() const
 void term_win::resize(TERM_LEN w, TERM_LEN h)
 {
     /* Ignore non-changes */
-    if (this->a.size() == static_cast<size_t>(h) && this->a[0].size() == static_cast<size_t>(w)) {
+    if ((this->a.height() == h) && (this->a.width() == w)) {
         return;
     }
 
-    this->a.resize(h, std::vector<TERM_COLOR>(w));
-    this->c.resize(h, std::vector<char>(w));
-    this->ta.resize(h, std::vector<TERM_COLOR>(w));
-    this->tc.resize(h, std::vector<char>(w));
-
-    for (TERM_LEN y = 0; y < h; y++) {
-        this->a[y].resize(w);
-        this->c[y].resize(w);
-        this->ta[y].resize(w);
-        this->tc[y].resize(w);
-    }
+    this->a.resize(w, h);
+    this->c.resize(w, h);
+    this->ta.resize(w, h);
+    this->tc.resize(w, h);
 
     /* Illegal cursor */
     if (this->cx >= w) {
@@ -490,17 +470,17 @@ static void term_queue_chars(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR a, std::s
 {
     TERM_LEN x1 = -1, x2 = -1;
 
-    auto &scr_aa = game_term->scr->a[y];
+    auto *scr_aa = game_term->scr->a[y];
 #ifdef JP
-    auto &scr_cc = game_term->scr->c[y];
+    auto *scr_cc = game_term->scr->c[y];
 
-    auto &scr_taa = game_term->scr->ta[y];
-    auto &scr_tcc = game_term->scr->tc[y];
+    auto *scr_taa = game_term->scr->ta[y];
+    auto *scr_tcc = game_term->scr->tc[y];
 #else
-    auto &scr_cc = game_term->scr->c[y];
+    auto *scr_cc = game_term->scr->c[y];
 
-    auto &scr_taa = game_term->scr->ta[y];
-    auto &scr_tcc = game_term->scr->tc[y];
+    auto *scr_taa = game_term->scr->ta[y];
+    auto *scr_tcc = game_term->scr->tc[y];
 #endif
 
 #ifdef JP
@@ -618,23 +598,71 @@ static void term_queue_chars(TERM_LEN x, TERM_LEN y, int n, TERM_COLOR a, std::s
 
 /*** Refresh routines ***/
 
+/* 変化の無いマスを一括で読み飛ばす単位 */
+constexpr TERM_LEN FRESH_SPAN = 8;
+static_assert(sizeof(TERM_COLOR) == 1);
+
+static uint64_t load_span(const void *p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/*!
+ * @brief 行の x 列目から FRESH_SPAN マスが表示済みの内容から変化していないかを調べる
+ * @param y 行
+ * @param x 調べる区間の先頭の列
+ * @param x2 変更のあった列の右端
+ * @param with_tiles タイルの属性と文字も比べるならtrue
+ * @return 区間が全て変化しておらず、まとめて読み飛ばせるならtrue
+ * @details
+ * 日本語版では全角文字の1バイト目と2バイト目の組は行の先頭から辿らないと決まらないため、
+ * 最上位ビットの立った文字を含む区間は1マスずつ調べる.
+ */
+static bool is_unchanged_span(TERM_LEN y, TERM_LEN x, TERM_LEN x2, bool with_tiles)
+{
+    if (x + FRESH_SPAN - 1 > x2) {
+        return false;
+    }
+
+    const auto &old = *game_term->old;
+    const auto &scr = *game_term->scr;
+    const auto scr_c = load_span(&scr.c[y][x]);
+    if ((load_span(&old.a[y][x]) != load_span(&scr.a[y][x])) || (load_span(&old.c[y][x]) != scr_c)) {
+        return false;
+    }
+
+#ifdef JP
+    if ((scr_c & 0x8080808080808080ULL) != 0) {
+        return false;
+    }
+#endif
+
+    if (!with_tiles) {
+        return true;
+    }
+
+    return (load_span(&old.ta[y][x]) == load_span(&scr.ta[y][x])) && (load_span(&old.tc[y][x]) == load_span(&scr.tc[y][x]));
+}
+
 /*
  * Flush a row of the current window (see "term_fresh")
  * Display text using "term_pict()"
  */
 static void term_fresh_row_pict(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
 {
-    auto &old_aa = game_term->old->a[y];
-    auto &old_cc = game_term->old->c[y];
+    auto *old_aa = game_term->old->a[y];
+    auto *old_cc = game_term->old->c[y];
 
-    const auto &scr_aa = game_term->scr->a[y];
-    const auto &scr_cc = game_term->scr->c[y];
+    const auto *scr_aa = game_term->scr->a[y];
+    const auto *scr_cc = game_term->scr->c[y];
 
-    auto &old_taa = game_term->old->ta[y];
-    auto &old_tcc = game_term->old->tc[y];
+    auto *old_taa = game_term->old->ta[y];
+    auto *old_tcc = game_term->old->tc[y];
 
-    const auto &scr_taa = game_term->scr->ta[y];
-    const auto &scr_tcc = game_term->scr->tc[y];
+    const auto *scr_taa = game_term->scr->ta[y];
+    const auto *scr_tcc = game_term->scr->tc[y];
 
     TERM_COLOR ota;
     char otc;
@@ -660,6 +688,12 @@ static void term_fresh_row_pict(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
 #endif
     /* Scan "modified" columns */
     for (TERM_LEN x = x1; x <= x2; x++) {
+        /* Skip unchanged spans */
+        if ((fn == 0) && is_unchanged_span(y, x, x2, true)) {
+            x += FRESH_SPAN - 1;
+            continue;
+        }
+
         /* See what is currently here */
         oa = old_aa[x];
         oc = old_cc[x];
@@ -744,16 +778,16 @@ static void term_fresh_row_pict(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
  */
 static void term_fresh_row_both(TERM_LEN y, int x1, int x2)
 {
-    auto &old_aa = game_term->old->a[y];
-    auto &old_cc = game_term->old->c[y];
+    auto *old_aa = game_term->old->a[y];
+    auto *old_cc = game_term->old->c[y];
 
-    const auto &scr_aa = game_term->scr->a[y];
-    const auto &scr_cc = game_term->scr->c[y];
+    const auto *scr_aa = game_term->scr->a[y];
+    const auto *scr_cc = game_term->scr->c[y];
 
-    auto &old_taa = game_term->old->ta[y];
-    auto &old_tcc = game_term->old->tc[y];
-    const auto &scr_taa = game_term->scr->ta[y];
-    const auto &scr_tcc = game_term->scr->tc[y];
+    auto *old_taa = game_term->old->ta[y];
+    auto *old_tcc = game_term->old->tc[y];
+    const auto *scr_taa = game_term->scr->ta[y];
+    const auto *scr_tcc = game_term->scr->tc[y];
 
     TERM_COLOR ota;
     char otc;
@@ -784,6 +818,12 @@ static void term_fresh_row_both(TERM_LEN y, int x1, int x2)
 #endif
     /* Scan "modified" columns */
     for (TERM_LEN x = x1; x <= x2; x++) {
+        /* Skip unchanged spans */
+        if ((fn == 0) && is_unchanged_span(y, x, x2, true)) {
+            x += FRESH_SPAN - 1;
+            continue;
+        }
+
         /* See what is currently here */
         oa = old_aa[x];
         oc = old_cc[x];
@@ -945,11 +985,11 @@ static void term_fresh_row_both(TERM_LEN y, int x1, int x2)
  */
 static void term_fresh_row_text(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
 {
-    auto &old_aa = game_term->old->a[y];
-    auto &old_cc = game_term->old->c[y];
+    auto *old_aa = game_term->old->a[y];
+    auto *old_cc = game_term->old->c[y];
 
-    const auto &scr_aa = game_term->scr->a[y];
-    const auto &scr_cc = game_term->scr->c[y];
+    const auto *scr_aa = game_term->scr->a[y];
+    const auto *scr_cc = game_term->scr->c[y];
 
     /* The "always_text" flag */
     int always_text = game_term->always_text;
@@ -986,6 +1026,12 @@ static void term_fresh_row_text(TERM_LEN y, TERM_LEN x1, TERM_LEN x2)
 #endif
     /* Scan "modified" columns */
     for (TERM_LEN x = x1; x <= x2; x++) {
+        /* Skip unchanged spans */
+        if ((fn == 0) && is_unchanged_span(y, x, x2, false)) {
+            x += FRESH_SPAN - 1;
+            continue;
+        }
+
         /* See what is currently here */
         oa = old_aa[x];
         oc = old_cc[x];
@@ -1148,11 +1194,11 @@ errr term_fresh(void)
 
         /* Wipe each row */
         for (TERM_LEN y = 0; y < h; y++) {
-            auto &aa = old->a[y];
-            auto &cc = old->c[y];
+            auto *aa = old->a[y];
+            auto *cc = old->c[y];
 
-            auto &taa = old->ta[y];
-            auto &tcc = old->tc[y];
+            auto *taa = old->ta[y];
+            auto *tcc = old->tc[y];
 
             /* Wipe each column */
             for (TERM_LEN x = 0; x < w; x++) {
@@ -1187,11 +1233,11 @@ errr term_fresh(void)
             TERM_LEN tx = old->cx;
             TERM_LEN ty = old->cy;
 
-            const auto &old_aa = old->a[ty];
-            const auto &old_cc = old->c[ty];
+            const auto *old_aa = old->a[ty];
+            const auto *old_cc = old->c[ty];
 
-            const auto &old_taa = old->ta[ty];
-            const auto &old_tcc = old->tc[ty];
+            const auto *old_taa = old->ta[ty];
+            const auto *old_tcc = old->tc[ty];
 
             TERM_COLOR ota = old_taa[tx];
             char otc = old_tcc[tx];
@@ -1631,11 +1677,11 @@ errr term_erase(TERM_LEN x, TERM_LEN y, std::optional<int> n_opt)
     }
 
     /* Fast access */
-    auto &scr_aa = game_term->scr->a[y];
-    auto &scr_cc = game_term->scr->c[y];
+    auto *scr_aa = game_term->scr->a[y];
+    auto *scr_cc = game_term->scr->c[y];
 
-    auto &scr_taa = game_term->scr->ta[y];
-    auto &scr_tcc = game_term->scr->tc[y];
+    auto *scr_taa = game_term->scr->ta[y];
+    auto *scr_tcc = game_term->scr->tc[y];
 
 #ifdef JP
     /*
@@ -1732,11 +1778,11 @@ errr term_clear(void)
 
     /* Wipe each row */
     for (TERM_LEN y = 0; y < h; y++) {
-        auto &scr_aa = game_term->scr->a[y];
-        auto &scr_cc = game_term->scr->c[y];
+        auto *scr_aa = game_term->scr->a[y];
+        auto *scr_cc = game_term->scr->c[y];
 
-        auto &scr_taa = game_term->scr->ta[y];
-        auto &scr_tcc = game_term->scr->tc[y];
+        auto *scr_taa = game_term->scr->ta[y];
+        auto *scr_tcc = game_term->scr->tc[y];
 
         /* Wipe each column */
         for (TERM_LEN x = 0; x < w; x++) {
@@ -1816,7 +1862,7 @@ errr term_redraw_section(TERM_LEN x1, TERM_LEN y1, TERM_LEN x2, TERM_LEN y2)
         game_term->x1[i] = x1j;
         game_term->x2[i] = x2j;
 
-        auto &g_ptr = game_term->old->c[i];
+        auto *g_ptr = game_term->old->c[i];
 
         /* Clear the section so it is redrawn */
         for (int j = x1j; j <= x2j; j++) {
@@ -1827,7 +1873,7 @@ errr term_redraw_section(TERM_LEN x1, TERM_LEN y1, TERM_LEN x2, TERM_LEN y2)
         game_term->x1[i] = x1;
         game_term->x2[i] = x2;
 
-        auto &g_ptr = game_term->old->c[i];
+        auto *g_ptr = game_term->old->c[i];
 
         /* Clear the section so it is redrawn */
         for (int j = x1; j <= x2; j++) {
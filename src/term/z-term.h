@@ -10,6 +10,7 @@
 
 #include "system/angband.h"
 #include "system/h-basic.h"
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <stack>
@@ -17,6 +18,78 @@
 #include <utility>
 #include <vector>
 
+/* Special flags in the attr data */
+#define AF_BIGTILE2 0xf0
+#define AF_TILE1 0x80
+
+#ifdef JP
+/*
+ * 全角文字対応。
+ * 属性に全角文字の1バイト目、2バイト目も記憶。
+ * By FIRST
+ */
+#define AF_KANJI1 0x10
+#define AF_KANJI2 0x20
+#define AF_KANJIC 0x0f
+#endif
+
+/*!
+ * @brief term_win の属性1種類分の画面
+ * @details 全ての行を1つの配列に連続して並べて保持する. plane[y] は y 行目の先頭を指し、plane[y][x] で各マスを参照する.
+ */
+template <typename T>
+class term_plane {
+public:
+    term_plane(TERM_LEN w, TERM_LEN h)
+        : cells(static_cast<size_t>(w) * h)
+        , w(w)
+        , h(h)
+    {
+    }
+
+    T *operator[](TERM_LEN y)
+    {
+        return this->cells.data() + static_cast<size_t>(y) * this->w;
+    }
+
+    const T *operator[](TERM_LEN y) const
+    {
+        return this->cells.data() + static_cast<size_t>(y) * this->w;
+    }
+
+    TERM_LEN width() const
+    {
+        return this->w;
+    }
+
+    TERM_LEN height() const
+    {
+        return this->h;
+    }
+
+    /*!
+     * @brief 大きさを変更する. 新旧で重なる範囲の内容は保持する
+     */
+    void resize(TERM_LEN new_w, TERM_LEN new_h)
+    {
+        std::vector<T> new_cells(static_cast<size_t>(new_w) * new_h);
+        const auto copy_w = std::min(this->w, new_w);
+        const auto copy_h = std::min(this->h, new_h);
+        for (TERM_LEN y = 0; y < copy_h; y++) {
+            std::copy_n((*this)[y], copy_w, new_cells.data() + static_cast<size_t>(y) * new_w);
+        }
+
+        this->cells = std::move(new_cells);
+        this->w = new_w;
+        this->h = new_h;
+    }
+
+private:
+    std::vector<T> cells;
+    TERM_LEN w;
+    TERM_LEN h;
+};
+
 /*!
  * @brief A term_win is a "window" for a Term
  */
@@ -29,11 +102,11 @@ public:
     bool cu{}, cv{}; //!< Cursor Useless / Visible codes
     TERM_LEN cx{}, cy{}; //!< Cursor Location (see "Useless")
 
-    std::vector<std::vector<TERM_COLOR>> a; //!< Array[h*w] -- Attribute array
-    std::vector<std::vector<char>> c; //!< Array[h*w] -- Character array
+    term_plane<TERM_COLOR> a; //!< Array[h*w] -- Attribute array
+    term_plane<char> c; //!< Array[h*w] -- Character array
 
-    std::vector<std::vector<TERM_COLOR>> ta; //!< Note that the attr pair at(x, y) is a[y][x]
-    std::vector<std::vector<char>> tc; //!< Note that the char pair at(x, y) is c[y][x]
+    term_plane<TERM_COLOR> ta; //!< Note that the attr pair at(x, y) is a[y][x]
+    term_plane<char> tc; //!< Note that the char pair at(x, y) is c[y][x]
 
 private:
     term_win(TERM_LEN w, TERM_LEN h);
@@ -0,0 +1,126 @@
+/*!
+ * @brief 発見済みのアイテム一覧の差分更新のテストプログラム
+ *
+ * srcディレクトリで ./configure && make を済ませた後、以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -DHAVE_CONFIG_H -I. -include stdafx.h test/test-found-item-list.cpp test/test-game.cpp \
+ *     $(find . -name '*.o' ! -name main.o ! -name main-gcu.o ! -name main-x11.o) -lncursesw -lX11 -lcurl
+ *
+ * 引数にlibディレクトリを指定できる (省略時は ../lib/)
+ * アイテムの発見・消滅・移動・出現・認識を無作為に繰り返し、
+ * FoundItemList が差分から作った一覧と、毎回全体を並べ直した一覧が一致するか調べる
+ */
+
+#include "test/test-game.h"
+#include "system/baseitem-info.h"
+#include "system/floor-type-definition.h"
+#include "system/item-entity.h"
+#include "system/player-type-definition.h"
+#include "window/found-item-list.h"
+#include "world/world-object.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+std::mt19937 rng;
+
+int random_index(int size)
+{
+    return std::uniform_int_distribution<int>(0, size - 1)(rng);
+}
+
+/*!
+ * @brief 発見済みかどうかが指定の通りのアイテムを無作為に1つ選ぶ
+ * @return アイテムの添字 (無ければ0)
+ */
+OBJECT_IDX pick_item(bool found)
+{
+    const auto *floor_ptr = p_ptr->current_floor_ptr;
+    std::vector<OBJECT_IDX> candidates;
+    for (OBJECT_IDX i = 1; i < floor_ptr->o_max; i++) {
+        const auto &item = floor_ptr->o_list[i];
+        if (item.is_valid() && (item.marked.has(OmType::FOUND) == found)) {
+            candidates.push_back(i);
+        }
+    }
+
+    return candidates.empty() ? 0 : candidates[random_index(candidates.size())];
+}
+
+void mutate_floor()
+{
+    auto *floor_ptr = p_ptr->current_floor_ptr;
+    auto &o_list = floor_ptr->o_list;
+    const auto action = random_index(6);
+    const auto i = pick_item(action < 4);
+    if (i == 0) {
+        return;
+    }
+
+    auto &item = o_list[i];
+    switch (action) {
+    case 0: // 消滅
+        item.wipe();
+        floor_ptr->o_cnt--;
+        floor_ptr->o_free_list.push_back(i);
+        return;
+    case 1: // 移動
+        item.iy = static_cast<POSITION>(random_index(floor_ptr->height));
+        item.ix = static_cast<POSITION>(random_index(floor_ptr->width));
+        return;
+    case 2: // 認識
+        item.get_baseitem().aware = !item.get_baseitem().aware;
+        return;
+    case 3: // 出現
+        if (const auto j = o_pop(floor_ptr); j > 0) {
+            o_list[j].copy_from(&item);
+            o_list[j].to_h = static_cast<HIT_PROB>(random_index(10));
+            o_list[j].marked.set(OmType::FOUND);
+        }
+
+        return;
+    default: // 発見
+        item.marked.set(OmType::FOUND);
+        return;
+    }
+}
+
+std::vector<OBJECT_IDX> sort_from_scratch()
+{
+    const auto &o_list = p_ptr->current_floor_ptr->o_list;
+    std::vector<OBJECT_IDX> indices;
+    for (OBJECT_IDX i = 0; i < std::ssize(o_list); i++) {
+        if (FoundItemList::is_displayable(o_list[i])) {
+            indices.push_back(i);
+        }
+    }
+
+    std::sort(indices.begin(), indices.end(), [](OBJECT_IDX left, OBJECT_IDX right) { return FoundItemList::compare(p_ptr, left, right); });
+    return indices;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    init_test_game((argc > 1) ? argv[1] : "../lib/");
+    auto mismatches = 0;
+    for (auto level = 1; level <= 90; level += 11) {
+        generate_test_floor(1, level);
+        for (auto &item : p_ptr->current_floor_ptr->o_list) {
+            item.marked.reset(OmType::FOUND);
+        }
+
+        for (auto step = 0; step < 500; step++) {
+            mutate_floor();
+            if (FoundItemList::get_instance().update(p_ptr) != sort_from_scratch()) {
+                std::cout << "mismatch: level=" << level << " step=" << step << std::endl;
+                mismatches++;
+            }
+        }
+    }
+
+    std::cout << "mismatches=" << mismatches << std::endl;
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+/*!
+ * @brief テストプログラム共通の初期化処理
+ */
+
+#include "test/test-game.h"
+#include "birth/game-play-initializer.h"
+#include "floor/floor-generator.h"
+#include "game-option/input-options.h"
+#include "main/angband-initializer.h"
+#include "player-info/class-info.h"
+#include "player-info/race-info.h"
+#include "player/player-personality.h"
+#include "player/race-info-table.h"
+#include "system/floor-type-definition.h"
+#include "system/player-type-definition.h"
+#include "term/gameterm.h"
+#include "term/z-term.h"
+#include "util/angband-files.h"
+#include "world/world.h"
+
+namespace {
+errr text_hook(TERM_LEN, TERM_LEN, int, TERM_COLOR, concptr)
+{
+    return 0;
+}
+
+errr wipe_hook(TERM_LEN, TERM_LEN, int)
+{
+    return 0;
+}
+
+errr curs_hook(TERM_LEN, TERM_LEN)
+{
+    return 0;
+}
+
+errr xtra_hook(int, int)
+{
+    return 0;
+}
+
+term_type test_term;
+}
+
+/*!
+ * @brief 描画を捨てる端末をメインウィンドウとして用意する
+ */
+void init_test_term()
+{
+    term_init(&test_term, 80, 24, 256);
+    test_term.text_hook = text_hook;
+    test_term.wipe_hook = wipe_hook;
+    test_term.curs_hook = curs_hook;
+    test_term.bigcurs_hook = curs_hook;
+    test_term.xtra_hook = xtra_hook;
+    angband_terms[0] = &test_term;
+    term_activate(&test_term);
+}
+
+/*!
+ * @brief ゲームのデータを読み込み、人間の戦士をプレイヤーとする
+ * @param lib_path libディレクトリのパス
+ */
+void init_test_game(const char *lib_path)
+{
+    init_file_paths(lib_path);
+    init_test_term();
+    init_angband(p_ptr, true);
+    player_wipe_without_name(p_ptr);
+    p_ptr->prace = PlayerRaceType::HUMAN;
+    p_ptr->pclass = PlayerClassType::WARRIOR;
+    p_ptr->ppersonality = PERSONALITY_ORDINARY;
+    cp_ptr = &class_info[enum2i(p_ptr->pclass)];
+    rp_ptr = &race_info[enum2i(p_ptr->prace)];
+    ap_ptr = &personality_info[p_ptr->ppersonality];
+    auto_more = true;
+}
+
+/*!
+ * @brief フロアを生成する
+ * @param dungeon_id ダンジョンID (0なら荒野)
+ * @param level 階層
+ */
+void generate_test_floor(int dungeon_id, int level)
+{
+    auto *floor_ptr = p_ptr->current_floor_ptr;
+    w_ptr->character_dungeon = false;
+    floor_ptr->set_dungeon_index(dungeon_id);
+    floor_ptr->dun_level = level;
+    floor_ptr->base_level = level;
+    generate_floor(p_ptr);
+    floor_ptr->view_n = 0;
+    w_ptr->character_dungeon = true;
+}
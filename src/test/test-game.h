@@ -0,0 +1,12 @@
+#pragma once
+
+/*!
+ * @brief テストプログラム共通の初期化処理
+ *
+ * 描画を捨てる80x24の端末を用意し、ゲームのデータを読み込んでテスト用のキャラクターを作る.
+ * テストプログラムと一緒に test/test-game.cpp をコンパイルして使う.
+ */
+
+void init_test_term();
+void init_test_game(const char *lib_path);
+void generate_test_floor(int dungeon_id, int level);
@@ -0,0 +1,84 @@
+/*!
+ * @brief メッセージ履歴のテストプログラム
+ *
+ * srcディレクトリで ./configure && make を済ませた後、以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -DHAVE_CONFIG_H -I. -include stdafx.h test/test-message-log.cpp \
+ *     $(find . -name '*.o' ! -name main.o ! -name main-gcu.o ! -name main-x11.o) -lncursesw -lX11 -lcurl
+ *
+ * 共有する文字列と一度きりの文字列を MESSAGE_MAX 件の数倍追加し、
+ * リングバッファが一周した後や文字列の領域を詰め直した後も、履歴が追加した順の通りに読めるか調べる
+ */
+
+#include "view/display-messages.h"
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+std::mt19937 rng(20240601);
+
+/*!
+ * @brief 直前と異なるメッセージを作る
+ * @details 半分は少数の文字列から選んで共有させ、残りは通し番号付きの一度きりの文字列にする.
+ */
+std::string make_message(int serial, const std::deque<std::string> &expected)
+{
+    while (true) {
+        const auto pick = std::uniform_int_distribution<int>(0, 19)(rng);
+        auto msg = (pick < 10) ? "You hit the monster " + std::to_string(pick) + "." : "Message number " + std::to_string(serial) + std::string(pick, '.');
+        if (expected.empty() || (msg != expected.front())) {
+            return msg;
+        }
+    }
+}
+
+/*!
+ * @brief 履歴と期待値を比べる
+ * @return 一致しなかったメッセージの数
+ */
+int compare_history(const std::deque<std::string> &expected)
+{
+    if (message_num() != std::ssize(expected)) {
+        std::cout << "mismatch: count=" << message_num() << " expected=" << expected.size() << std::endl;
+        return 1;
+    }
+
+    auto mismatches = 0;
+    for (auto age = 0; age < message_num(); age++) {
+        const auto msg = message_str(age);
+        if ((msg != expected[age]) || (msg.data()[msg.length()] != '\0')) {
+            if (mismatches++ < 10) {
+                std::cout << "mismatch: age=" << age << " \"" << msg << "\" expected=\"" << expected[age] << "\"" << std::endl;
+            }
+        }
+    }
+
+    return mismatches;
+}
+}
+
+int main()
+{
+    std::deque<std::string> expected;
+    auto mismatches = 0;
+    for (auto serial = 0; serial < MESSAGE_MAX * 3; serial++) {
+        auto msg = make_message(serial, expected);
+        message_add(msg);
+        expected.push_front(std::move(msg));
+        if (std::ssize(expected) == MESSAGE_MAX) {
+            expected.pop_back();
+        }
+
+        if ((serial % 10007) == 0) {
+            mismatches += compare_history(expected);
+        }
+    }
+
+    message_add(expected.front());
+    expected.front().append(" <x2>");
+    mismatches += compare_history(expected);
+    std::cout << "mismatches=" << mismatches << std::endl;
+    return (mismatches == 0) ? 0 : 1;
+}
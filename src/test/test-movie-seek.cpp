@@ -0,0 +1,166 @@
+/*!
+ * @brief ムービーの頭出し再生のテストプログラム
+ *
+ * srcディレクトリで ./configure && make を済ませた後、以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -DHAVE_CONFIG_H -I. -include stdafx.h test/test-movie-seek.cpp test/test-game.cpp \
+ *     $(find . -name '*.o' ! -name main.o ! -name main-gcu.o ! -name main-x11.o) -lncursesw -lX11 -lcurl
+ *
+ * 無作為な描画を録画し、キーフレームを使って頭出しした画面が、
+ * キーフレームを取り除いたムービーを先頭から再生した画面と一致するか調べる
+ * (録画は一瞬で終わるため、キーフレームは一定のデータ量ごとに記録されたものを使う)
+ */
+
+#include "test/test-game.h"
+#include "io/movie-player.h"
+#include "io/record-play-movie.h"
+#include "term/z-term.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+
+namespace {
+std::mt19937 rng(20240601);
+
+int random_number(int n)
+{
+    return std::uniform_int_distribution<int>(0, n - 1)(rng);
+}
+
+/*!
+ * @brief 無作為な描画を録画する
+ */
+void record_random_movie(const std::filesystem::path &path, int frame_count)
+{
+    start_movie_recording(path);
+    term_clear();
+    term_fresh();
+    for (auto frame = 0; frame < frame_count; frame++) {
+        const auto draw_count = random_number(20);
+        for (auto i = 0; i < draw_count; i++) {
+            const auto is_repeat = random_number(3) == 0;
+            std::string text;
+            for (auto len = 1 + random_number(10); len > 0; len--) {
+                text.push_back(is_repeat ? '#' : (random_number(4) == 0) ? ' ' : static_cast<char>('a' + random_number(26)));
+            }
+
+            term_putstr(random_number(70), random_number(24), -1, static_cast<TERM_COLOR>(1 + random_number(15)), text);
+        }
+
+        if (random_number(50) == 0) {
+            term_erase(random_number(40), random_number(24));
+        }
+
+        if (random_number(300) == 0) {
+            term_clear();
+        }
+
+        term_fresh();
+    }
+
+    finish_movie_recording();
+}
+
+/*!
+ * @brief キーフレームを取り除き、先頭から再生するしかない旧形式のムービーを作る
+ */
+void strip_keyframes(const std::filesystem::path &from, const std::filesystem::path &to)
+{
+    std::ifstream ifs(from, std::ios::binary);
+    const std::string data{ std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>() };
+    std::ofstream ofs(to, std::ios::binary);
+    auto is_in_keyframe = false;
+    for (size_t pos = 0; pos < data.size();) {
+        const std::string record(data.c_str() + pos);
+        pos += record.size() + 1;
+        if (record.starts_with('k')) {
+            is_in_keyframe = true;
+            continue;
+        }
+
+        if (record.starts_with('K')) {
+            is_in_keyframe = false;
+            continue;
+        }
+
+        if (is_in_keyframe) {
+            continue;
+        }
+
+        ofs.write(record.data(), record.size() + 1);
+    }
+}
+
+bool is_same_screen(const MovieScreen &left, const MovieScreen &right)
+{
+    if ((left.width != right.width) || (left.height != right.height)) {
+        return false;
+    }
+
+    for (auto y = 0; y < left.height; y++) {
+        for (auto x = 0; x < left.width; x++) {
+            const auto ch = left.get_char(x, y);
+            if ((ch != right.get_char(x, y)) || ((ch != ' ') && (left.get_attr(x, y) != right.get_attr(x, y)))) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+}
+
+int main()
+{
+    init_test_term();
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto movie_path = dir / "test-movie-seek.amv";
+    const auto linear_path = dir / "test-movie-seek-linear.amv";
+    record_random_movie(movie_path, 10000);
+    strip_keyframes(movie_path, linear_path);
+
+    MoviePlayer seeker(movie_path);
+    MoviePlayer linear(linear_path);
+    if (!seeker.is_loaded() || !linear.is_loaded() || (seeker.get_frame_count() != linear.get_frame_count())) {
+        std::cout << "failed to load movies" << std::endl;
+        return 1;
+    }
+
+    const auto frame_count = seeker.get_frame_count();
+    auto mismatches = 0;
+    for (auto i = 0; i < 300; i++) {
+        const auto frame = random_number(frame_count);
+        seeker.seek_frame(frame);
+        linear.seek_frame(frame);
+        if (!is_same_screen(seeker.get_screen(), linear.get_screen()) && (mismatches++ < 10)) {
+            std::cout << "mismatch: seek frame=" << frame << std::endl;
+        }
+    }
+
+    for (auto frame = frame_count - 1; frame > frame_count - 50; frame--) {
+        seeker.seek_frame(frame);
+        seeker.step_backward();
+        linear.seek_frame(frame - 1);
+        if (!is_same_screen(seeker.get_screen(), linear.get_screen()) && (mismatches++ < 10)) {
+            std::cout << "mismatch: step back from frame=" << frame << std::endl;
+        }
+    }
+
+    seeker.seek_frame(frame_count - 1);
+    const auto &screen = seeker.get_screen();
+    for (auto y = 0; y < screen.height; y++) {
+        for (auto x = 0; x < screen.width; x++) {
+            if ((screen.get_char(x, y) != game_term->old->c[y][x]) && (mismatches++ < 10)) {
+                std::cout << "mismatch: last frame at (" << y << "," << x << ")" << std::endl;
+            }
+        }
+    }
+
+    std::filesystem::remove(movie_path);
+    std::filesystem::remove(linear_path);
+    std::cout << "frames=" << frame_count << " mismatches=" << mismatches << std::endl;
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+/*!
+ * @brief 視界計算 update_view() の新旧実装の比較テストプログラム
+ *
+ * srcディレクトリで ./configure && make を済ませた後、以下のコマンドでコンパイルして実行する
+ *
+ * g++ -std=c++20 -DHAVE_CONFIG_H -I. -include stdafx.h test/test-update-view.cpp test/test-game.cpp \
+ *     $(find . -name '*.o' ! -name main.o ! -name main-gcu.o ! -name main-x11.o) -lncursesw -lX11 -lcurl
+ *
+ * 引数にlibディレクトリを指定できる (省略時は ../lib/)
+ * ダンジョンと荒野のフロアを生成し、床の全てのマスと一部の壁のマスを視点として
+ * 従来の帯の走査と八分円ごとの走査の視界 (CAVE_VIEW の集合と登録順) が一致するか調べる
+ */
+
+#include "test/test-game.h"
+#include "floor/cave.h"
+#include "game-option/map-screen-options.h"
+#include "player/player-view.h"
+#include "system/floor-type-definition.h"
+#include "system/grid-type-definition.h"
+#include "system/player-type-definition.h"
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace {
+std::vector<std::pair<int, int>> take_view(FloorType *floor_ptr)
+{
+    std::vector<std::pair<int, int>> view;
+    for (auto i = 0; i < floor_ptr->view_n; i++) {
+        view.emplace_back(floor_ptr->view_y[i], floor_ptr->view_x[i]);
+    }
+
+    for (auto i = 0; i < floor_ptr->redraw_n; i++) {
+        floor_ptr->grid_array[floor_ptr->redraw_y[i]][floor_ptr->redraw_x[i]].info &= ~(CAVE_NOTE | CAVE_REDRAW);
+    }
+
+    floor_ptr->redraw_n = 0;
+    return view;
+}
+
+/*!
+ * @brief 現在のフロアの各マスを視点として新旧の視界を比べる
+ * @param all_walls 壁のマスも全て視点にするか (偽なら7マスに1つ)
+ * @return 視界が一致しなかったマスの数
+ */
+int compare_floor(bool all_walls)
+{
+    auto *floor_ptr = p_ptr->current_floor_ptr;
+    auto mismatches = 0;
+    for (auto y = 1; y < floor_ptr->height - 1; y++) {
+        for (auto x = 1; x < floor_ptr->width - 1; x++) {
+            if (!all_walls && !feat_supports_los(floor_ptr->grid_array[y][x].feat) && ((x + y) % 7)) {
+                continue;
+            }
+
+            p_ptr->y = y;
+            p_ptr->x = x;
+            update_view_legacy(p_ptr);
+            const auto legacy_view = take_view(floor_ptr);
+            update_view_octant(p_ptr);
+            if (legacy_view != take_view(floor_ptr)) {
+                std::cout << "mismatch: dungeon=" << floor_ptr->dungeon_idx << " level=" << floor_ptr->dun_level << " at (" << y << "," << x << ")" << std::endl;
+                mismatches++;
+            }
+        }
+    }
+
+    return mismatches;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    init_test_game((argc > 1) ? argv[1] : "../lib/");
+    auto mismatches = 0;
+    for (const auto dungeon_id : { 1, 2 }) {
+        for (auto level = 1; level <= 90; level += 11) {
+            generate_test_floor(dungeon_id, level);
+            mismatches += compare_floor(false);
+        }
+    }
+
+    view_reduce_view = true;
+    for (auto i = 0; i < 3; i++) {
+        generate_test_floor(0, 0);
+        mismatches += compare_floor(true);
+    }
+
+    std::cout << "mismatches=" << mismatches << std::endl;
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -473,34 +473,47 @@ size_t angband_strcat(char *buf, std::string_view src, size_t bufsize)
     }
 }
 
-/*
- * A copy of ANSI strstr()
- *
- * angband_strstr() can handle Kanji strings correctly.
+/*!
+ * @brief 漢字の途中を除いて部分文字列を探す
+ * @return 見つかった位置 (見つからなければ std::string_view::npos)
  */
-char *angband_strstr(const char *haystack, std::string_view needle)
+static size_t find_substr(std::string_view haystack, std::string_view needle)
 {
-    std::string_view haystack_view(haystack);
-    auto l1 = haystack_view.length();
+    auto l1 = haystack.length();
     auto l2 = needle.length();
     if (l1 < l2) {
-        return nullptr;
+        return std::string_view::npos;
     }
 
     for (size_t i = 0; i <= l1 - l2; i++) {
-        const auto part = haystack_view.substr(i);
+        const auto part = haystack.substr(i);
         if (part.starts_with(needle)) {
-            return const_cast<char *>(haystack) + i;
+            return i;
         }
 
 #ifdef JP
-        if (iskanji(*(haystack + i))) {
+        if (iskanji(haystack[i])) {
             i++;
         }
 #endif
     }
 
-    return nullptr;
+    return std::string_view::npos;
+}
+
+/*
+ * A copy of ANSI strstr()
+ *
+ * angband_strstr() can handle Kanji strings correctly.
+ */
+char *angband_strstr(const char *haystack, std::string_view needle)
+{
+    const auto pos = find_substr(haystack, needle);
+    if (pos == std::string_view::npos) {
+        return nullptr;
+    }
+
+    return const_cast<char *>(haystack) + pos;
 }
 
 /*
@@ -600,9 +613,9 @@ int strrncmp(const char *s1, const char *s2, int len)
  * @param src 比較元の文字列
  * @param find 比較したい文字列
  */
-bool str_find(const std::string &src, std::string_view find)
+bool str_find(std::string_view src, std::string_view find)
 {
-    return angband_strstr(src.data(), find) != nullptr;
+    return find_substr(src, find) != std::string_view::npos;
 }
 
 /**
@@ -4,6 +4,7 @@
 #include "autopick/autopick-util.h"
 #include "floor/cave.h"
 #include "floor/geometry.h"
+#include "floor/line-of-sight-cache.h"
 #include "game-option/map-screen-options.h"
 #include "game-option/special-options.h"
 #include "grid/feature.h"
@@ -28,7 +29,11 @@
 #include "util/bit-flags-calculator.h"
 #include "window/main-window-util.h"
 #include "world/world.h"
+#include <array>
+#include <cstdint>
 #include <span>
+#include <utility>
+#include <vector>
 
 byte display_autopick; /*!< 自動拾い状態の設定フラグ */
 
@@ -38,6 +43,66 @@ const std::string image_objects = R"(?/|\"!$()_-=[]{},~)";
 
 /* 一般的にモンスターシンボルとして扱われる記号を定義する(幻覚処理向け) / Hack -- Legal monster codes */
 const std::string image_monsters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+/* 地形部分の表示に関わるマスの情報フラグ */
+constexpr BIT_FLAGS GLYPH_INFO_MASK = CAVE_MARK | CAVE_LITE | CAVE_MNLT | CAVE_GLOW | CAVE_MNDK | CAVE_VIEW | CAVE_UNSAFE;
+
+/*!
+ * @brief マスの地形部分の表示 (表示に使う地形と明るさの種別)
+ * @details シンボルと色そのものではなく地形IDで持つため、表示設定を変えた時も記録を捨てずに済む.
+ */
+struct terrain_glyph {
+    FEAT_IDX terrain_id;
+    int lighting; //!< F_LIT_*
+};
+
+/*!
+ * @brief 地形部分の表示を左右する、マス以外の条件
+ */
+struct terrain_glyph_context {
+    const FloorType *floor_ptr = nullptr;
+    uint32_t terrain_version = 0; //!< 周囲のマスの地形が変わったかの判定に使う
+    BIT_FLAGS see_nocto = 0;
+    bool is_blind = false;
+    bool wild_mode = false;
+    bool is_daytime = false;
+    uint8_t view_options = 0; //!< 地形の表示に関わるオプションをビットで並べたもの
+
+    bool operator==(const terrain_glyph_context &) const = default;
+};
+
+/*!
+ * @brief マス1つ分の地形部分の表示の記録
+ */
+struct terrain_glyph_memo {
+    FEAT_IDX feat = 0;
+    FEAT_IDX mimic = 0;
+    BIT_FLAGS info = 0; //!< GLYPH_INFO_MASK の範囲の情報フラグ
+    terrain_glyph glyph{ 0, F_LIT_STANDARD };
+    bool is_valid = false;
+};
+
+/*!
+ * @brief 地形部分の表示の記録
+ * @details
+ * 全体マップの描き直しでは画面内の全マスについて map_info() を呼ぶが、地形部分の表示はマスの地形と情報フラグ、
+ * プレイヤーの状態、表示オプション、周囲の地形が変わらない限り同じになる.
+ * マスごとに前回の入力と結果を記録し、入力が同じなら結果を使い回す.
+ * アイテムとモンスターの部分は幻覚などで乱数を使うため、毎回判定する.
+ */
+struct terrain_glyph_cache {
+    terrain_glyph_context context{};
+    int height = 0;
+    int width = 0;
+    std::vector<terrain_glyph_memo> memos{};
+};
+
+/*!
+ * @brief 直近に使った条件2つ分の記録
+ * @details 縮小マップは表示オプションを一時的に切り替えて map_info() を呼ぶため、通常のマップ用と縮小マップ用の記録を並べて持つ.
+ * 先頭が最後に使った記録.
+ */
+std::array<terrain_glyph_cache, 2> glyph_caches{};
 }
 
 /*!
@@ -145,117 +210,169 @@ static bool is_revealed_wall(FloorType *floor_ptr, int y, int x)
 }
 
 /*!
- * @brief 指定した座標の地形の表示属性を取得する
+ * @brief マスの地形部分の表示を決める
  * @param player_ptr プレイヤー情報への参照ポインタ
+ * @param floor 階の情報への参照
+ * @param grid 対象のマス
  * @param y 階の中のy座標
- * @param x 階の中のy座標
- * @param ap 文字色属性
- * @param cp 文字種属性
- * @param tap 文字色属性(タイル)
- * @param tcp 文字種属性(タイル)
- * @todo 強力発動コピペの嵐…ポインタ引数の嵐……Fuuu^h^hck!!
+ * @param x 階の中のx座標
+ * @param is_cacheable 結果が周囲のマスの明るさに依存し、記録できない時にfalseを設定する
+ * @return 表示に使う地形と明るさの種別
  */
-void map_info(PlayerType *player_ptr, POSITION y, POSITION x, TERM_COLOR *ap, char *cp, TERM_COLOR *tap, char *tcp)
+static terrain_glyph decide_terrain_glyph(PlayerType *player_ptr, FloorType &floor, Grid &grid, POSITION y, POSITION x, bool &is_cacheable)
 {
-    auto &floor = *player_ptr->current_floor_ptr;
-    const Pos2D pos(y, x);
-    auto &grid = floor.get_grid(pos);
-    auto &terrains = TerrainList::get_instance();
-    auto *terrain_mimic_ptr = &grid.get_terrain_mimic();
-    TERM_COLOR a;
-    char c;
-    if (terrain_mimic_ptr->flags.has_not(TerrainCharacteristics::REMEMBER)) {
+    const auto &terrain = grid.get_terrain_mimic();
+    const terrain_glyph unsafe_glyph{ (view_unsafe_grids && (grid.info & CAVE_UNSAFE)) ? feat_undetected : feat_none, F_LIT_STANDARD };
+    terrain_glyph glyph{ grid.get_feat_mimic(), F_LIT_STANDARD };
+    const auto is_blind = player_ptr->effects()->blindness()->is_blind();
+    if (terrain.flags.has_not(TerrainCharacteristics::REMEMBER)) {
         auto is_visible = any_bits(grid.info, (CAVE_MARK | CAVE_LITE | CAVE_MNLT));
         auto is_glowing = match_bits(grid.info, CAVE_GLOW | CAVE_MNDK, CAVE_GLOW);
         auto can_view = grid.is_view() && (is_glowing || player_ptr->see_nocto);
-        const auto is_blind = player_ptr->effects()->blindness()->is_blind();
-        if (!is_blind && (is_visible || can_view)) {
-            a = terrain_mimic_ptr->x_attr[F_LIT_STANDARD];
-            c = terrain_mimic_ptr->x_char[F_LIT_STANDARD];
-            if (player_ptr->wild_mode) {
-                if (view_special_lite && !w_ptr->is_daytime()) {
-                    a = terrain_mimic_ptr->x_attr[F_LIT_DARK];
-                    c = terrain_mimic_ptr->x_char[F_LIT_DARK];
+        if (is_blind || (!is_visible && !can_view)) {
+            return unsafe_glyph;
+        }
+
+        if (player_ptr->wild_mode) {
+            if (view_special_lite && !w_ptr->is_daytime()) {
+                glyph.lighting = F_LIT_DARK;
+            }
+        } else if (darkened_grid(player_ptr, &grid)) {
+            return unsafe_glyph;
+        } else if (view_special_lite) {
+            if (grid.info & (CAVE_LITE | CAVE_MNLT)) {
+                if (view_yellow_lite) {
+                    glyph.lighting = F_LIT_LITE;
                 }
-            } else if (darkened_grid(player_ptr, &grid)) {
-                const auto unsafe_terrain_id = (view_unsafe_grids && (grid.info & CAVE_UNSAFE)) ? feat_undetected : feat_none;
-                terrain_mimic_ptr = &terrains[unsafe_terrain_id];
-                a = terrain_mimic_ptr->x_attr[F_LIT_STANDARD];
-                c = terrain_mimic_ptr->x_char[F_LIT_STANDARD];
-            } else if (view_special_lite) {
-                if (grid.info & (CAVE_LITE | CAVE_MNLT)) {
-                    if (view_yellow_lite) {
-                        a = terrain_mimic_ptr->x_attr[F_LIT_LITE];
-                        c = terrain_mimic_ptr->x_char[F_LIT_LITE];
-                    }
-                } else if ((grid.info & (CAVE_GLOW | CAVE_MNDK)) != CAVE_GLOW) {
-                    a = terrain_mimic_ptr->x_attr[F_LIT_DARK];
-                    c = terrain_mimic_ptr->x_char[F_LIT_DARK];
-                } else if (!(grid.info & CAVE_VIEW)) {
-                    if (view_bright_lite) {
-                        a = terrain_mimic_ptr->x_attr[F_LIT_DARK];
-                        c = terrain_mimic_ptr->x_char[F_LIT_DARK];
-                    }
+            } else if ((grid.info & (CAVE_GLOW | CAVE_MNDK)) != CAVE_GLOW) {
+                glyph.lighting = F_LIT_DARK;
+            } else if (!(grid.info & CAVE_VIEW)) {
+                if (view_bright_lite) {
+                    glyph.lighting = F_LIT_DARK;
                 }
             }
-        } else {
-            const auto unsafe_terrain_id = (view_unsafe_grids && (grid.info & CAVE_UNSAFE)) ? feat_undetected : feat_none;
-            terrain_mimic_ptr = &terrains[unsafe_terrain_id];
-            a = terrain_mimic_ptr->x_attr[F_LIT_STANDARD];
-            c = terrain_mimic_ptr->x_char[F_LIT_STANDARD];
         }
-    } else {
-        if (grid.is_mark() && is_revealed_wall(&floor, y, x)) {
-            a = terrain_mimic_ptr->x_attr[F_LIT_STANDARD];
-            c = terrain_mimic_ptr->x_char[F_LIT_STANDARD];
-            const auto is_blind = player_ptr->effects()->blindness()->is_blind();
-            if (player_ptr->wild_mode) {
-                if (view_granite_lite && (is_blind || !w_ptr->is_daytime())) {
-                    a = terrain_mimic_ptr->x_attr[F_LIT_DARK];
-                    c = terrain_mimic_ptr->x_char[F_LIT_DARK];
-                }
-            } else if (darkened_grid(player_ptr, &grid) && !is_blind) {
-                if (terrain_mimic_ptr->flags.has_all_of({ TerrainCharacteristics::LOS, TerrainCharacteristics::PROJECT })) {
-                    const auto unsafe_terrain_id = (view_unsafe_grids && (grid.info & CAVE_UNSAFE)) ? feat_undetected : feat_none;
-                    terrain_mimic_ptr = &terrains[unsafe_terrain_id];
-                    a = terrain_mimic_ptr->x_attr[F_LIT_STANDARD];
-                    c = terrain_mimic_ptr->x_char[F_LIT_STANDARD];
-                } else if (view_granite_lite && view_bright_lite) {
-                    a = terrain_mimic_ptr->x_attr[F_LIT_DARK];
-                    c = terrain_mimic_ptr->x_char[F_LIT_DARK];
-                }
-            } else if (view_granite_lite) {
-                if (is_blind) {
-                    a = terrain_mimic_ptr->x_attr[F_LIT_DARK];
-                    c = terrain_mimic_ptr->x_char[F_LIT_DARK];
-                } else if (grid.info & (CAVE_LITE | CAVE_MNLT)) {
-                    if (view_yellow_lite) {
-                        a = terrain_mimic_ptr->x_attr[F_LIT_LITE];
-                        c = terrain_mimic_ptr->x_char[F_LIT_LITE];
-                    }
-                } else if (view_bright_lite) {
-                    if (!(grid.info & CAVE_VIEW)) {
-                        a = terrain_mimic_ptr->x_attr[F_LIT_DARK];
-                        c = terrain_mimic_ptr->x_char[F_LIT_DARK];
-                    } else if ((grid.info & (CAVE_GLOW | CAVE_MNDK)) != CAVE_GLOW) {
-                        a = terrain_mimic_ptr->x_attr[F_LIT_DARK];
-                        c = terrain_mimic_ptr->x_char[F_LIT_DARK];
-                    } else if (terrain_mimic_ptr->flags.has_not(TerrainCharacteristics::LOS) && !check_local_illumination(player_ptr, y, x)) {
-                        a = terrain_mimic_ptr->x_attr[F_LIT_DARK];
-                        c = terrain_mimic_ptr->x_char[F_LIT_DARK];
-                    }
+
+        return glyph;
+    }
+
+    if (!grid.is_mark() || !is_revealed_wall(&floor, y, x)) {
+        return unsafe_glyph;
+    }
+
+    if (player_ptr->wild_mode) {
+        if (view_granite_lite && (is_blind || !w_ptr->is_daytime())) {
+            glyph.lighting = F_LIT_DARK;
+        }
+    } else if (darkened_grid(player_ptr, &grid) && !is_blind) {
+        if (terrain.flags.has_all_of({ TerrainCharacteristics::LOS, TerrainCharacteristics::PROJECT })) {
+            return unsafe_glyph;
+        } else if (view_granite_lite && view_bright_lite) {
+            glyph.lighting = F_LIT_DARK;
+        }
+    } else if (view_granite_lite) {
+        if (is_blind) {
+            glyph.lighting = F_LIT_DARK;
+        } else if (grid.info & (CAVE_LITE | CAVE_MNLT)) {
+            if (view_yellow_lite) {
+                glyph.lighting = F_LIT_LITE;
+            }
+        } else if (view_bright_lite) {
+            if (!(grid.info & CAVE_VIEW)) {
+                glyph.lighting = F_LIT_DARK;
+            } else if ((grid.info & (CAVE_GLOW | CAVE_MNDK)) != CAVE_GLOW) {
+                glyph.lighting = F_LIT_DARK;
+            } else if (terrain.flags.has_not(TerrainCharacteristics::LOS)) {
+                is_cacheable = false;
+                if (!check_local_illumination(player_ptr, y, x)) {
+                    glyph.lighting = F_LIT_DARK;
                 }
             }
-        } else {
-            const auto unsafe_terrain_id = (view_unsafe_grids && (grid.info & CAVE_UNSAFE)) ? feat_undetected : feat_none;
-            terrain_mimic_ptr = &terrains[unsafe_terrain_id];
-            a = terrain_mimic_ptr->x_attr[F_LIT_STANDARD];
-            c = terrain_mimic_ptr->x_char[F_LIT_STANDARD];
         }
     }
 
+    return glyph;
+}
+
+/*!
+ * @brief 記録を使ってマスの地形部分の表示を得る
+ * @param player_ptr プレイヤー情報への参照ポインタ
+ * @param floor 階の情報への参照
+ * @param grid 対象のマス
+ * @param y 階の中のy座標
+ * @param x 階の中のx座標
+ * @return 表示に使う地形と明るさの種別
+ * @details フロアの生成中は地形が直接書き換えられるため記録を使わない.
+ */
+static terrain_glyph get_terrain_glyph(PlayerType *player_ptr, FloorType &floor, Grid &grid, POSITION y, POSITION x)
+{
+    auto is_cacheable = w_ptr->character_dungeon;
+    if (!is_cacheable) {
+        return decide_terrain_glyph(player_ptr, floor, grid, y, x, is_cacheable);
+    }
+
+    uint8_t view_options = 0;
+    for (const auto option : { view_special_lite, view_yellow_lite, view_bright_lite, view_granite_lite, view_unsafe_grids, view_hidden_walls, view_unsafe_walls }) {
+        view_options = static_cast<uint8_t>((view_options << 1) | (option ? 1 : 0));
+    }
+
+    const terrain_glyph_context context{
+        &floor,
+        LineOfSightCache::get_instance().get_terrain_version(),
+        player_ptr->see_nocto,
+        player_ptr->effects()->blindness()->is_blind(),
+        player_ptr->wild_mode,
+        w_ptr->is_daytime(),
+        view_options,
+    };
+    const auto is_matched = [&context, &floor](const terrain_glyph_cache &cache) {
+        return (cache.context == context) && (cache.height == floor.height) && (cache.width == floor.width);
+    };
+    if (!is_matched(glyph_caches[0])) {
+        std::swap(glyph_caches[0], glyph_caches[1]);
+    }
+
+    auto &cache = glyph_caches[0];
+    if (!is_matched(cache)) {
+        cache.context = context;
+        cache.height = floor.height;
+        cache.width = floor.width;
+        cache.memos.assign(floor.height * floor.width, {});
+    }
+
+    auto &memo = cache.memos[y * cache.width + x];
+    const auto info = grid.info & GLYPH_INFO_MASK;
+    if (memo.is_valid && (memo.feat == grid.feat) && (memo.mimic == grid.mimic) && (memo.info == info)) {
+        return memo.glyph;
+    }
+
+    const auto glyph = decide_terrain_glyph(player_ptr, floor, grid, y, x, is_cacheable);
+    memo = { grid.feat, grid.mimic, info, glyph, is_cacheable };
+    return glyph;
+}
+
+/*!
+ * @brief 指定した座標の地形の表示属性を取得する
+ * @param player_ptr プレイヤー情報への参照ポインタ
+ * @param y 階の中のy座標
+ * @param x 階の中のy座標
+ * @param ap 文字色属性
+ * @param cp 文字種属性
+ * @param tap 文字色属性(タイル)
+ * @param tcp 文字種属性(タイル)
+ * @todo 強力発動コピペの嵐…ポインタ引数の嵐……Fuuu^h^hck!!
+ */
+void map_info(PlayerType *player_ptr, POSITION y, POSITION x, TERM_COLOR *ap, char *cp, TERM_COLOR *tap, char *tcp)
+{
+    auto &floor = *player_ptr->current_floor_ptr;
+    const Pos2D pos(y, x);
+    auto &grid = floor.get_grid(pos);
+    const auto glyph = get_terrain_glyph(player_ptr, floor, grid, y, x);
+    const auto &terrain = TerrainList::get_instance()[glyph.terrain_id];
+    TERM_COLOR a = terrain.x_attr[glyph.lighting];
+    char c = terrain.x_char[glyph.lighting];
     if (feat_priority == -1) {
-        feat_priority = terrain_mimic_ptr->priority;
+        feat_priority = terrain.priority;
     }
 
     (*tap) = a;
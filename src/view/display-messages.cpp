@@ -12,10 +12,11 @@
 #include "term/term-color-types.h"
 #include "util/int-char-converter.h"
 #include "world/world.h"
-#include <deque>
-#include <map>
-#include <memory>
+#include <algorithm>
+#include <bit>
+#include <functional>
 #include <string>
+#include <vector>
 
 /* Used in msg_print() for "buffering" */
 bool msg_flag;
@@ -27,43 +28,198 @@ namespace {
 /*! 表示するメッセージの先頭位置 */
 static int msg_head_pos = 0;
 
-using msg_sp = std::shared_ptr<const std::string>;
-using msg_wp = std::weak_ptr<const std::string>;
-
-/** メッセージが同一かどうかを比較するためのラムダ式 */
-auto string_ptr_cmp = [](const std::string *a, const std::string *b) { return *a < *b; };
+/*!
+ * @brief 共有するメッセージの文字列
+ * @details 文字列の本体は message_log::arena に終端の'\0'付きで置く.
+ */
+struct interned_message {
+    uint32_t offset; //!< arena上の位置
+    uint32_t length; //!< 終端の'\0'を含まない長さ
+    uint32_t refs; //!< 履歴から参照している数
+    size_t hash;
+};
 
-/** 同一メッセージの検索に使用するmapオブジェクト。
- * 同一メッセージがあるかどうかを検索し、ヒットしたらweak_ptrからshared_ptrを作成しメッセージを共有する。
- * message_historyのカスタムデリータの中で参照するので、message_historyより先に宣言しなければならない事に注意。
+/*!
+ * @brief メッセージ履歴
+ * @details
+ * 履歴は MESSAGE_MAX 件のリングバッファで、各要素は文字列の番号だけを持つ.
+ * 同じ文字列はハッシュ表で探して共有し、文字列の本体は1つの連続した領域 (arena) に詰めて置く.
+ * 履歴から外れて参照が無くなった文字列の領域は、不要な部分が溜まった時にまとめて詰め直す.
  */
-std::map<const std::string *, msg_wp, decltype(string_ptr_cmp)> message_map(string_ptr_cmp);
+class message_log {
+public:
+    int size() const
+    {
+        return this->count;
+    }
 
-/** メッセージ履歴 */
-std::deque<msg_sp> message_history;
+    std::string_view get(int age) const
+    {
+        const auto &text = this->texts[this->ring[(this->head + age) % MESSAGE_MAX]];
+        return std::string_view(this->arena.data() + text.offset, text.length);
+    }
 
-/**
- * @brief メッセージを保持する msg_sp オブジェクトを生成する
- *
- * @tparam T メッセージの型。std::string / std::string_view / const char* 等
- * @param str メッセージ
- * @return 生成した msg_sp オブジェクト
- */
-template <typename T>
-msg_sp make_message(T &&str)
-{
-    /** std::stringオブジェクトと同時にmessage_mapのエントリも削除するカスタムデリータ */
-    auto deleter = [](std::string *s) {
-        message_map.erase(s);
-        delete s;
-    };
+    void push_front(std::string_view msg)
+    {
+        if (this->ring.empty()) {
+            this->ring.resize(MESSAGE_MAX);
+        }
+
+        this->head = (this->head + MESSAGE_MAX - 1) % MESSAGE_MAX;
+        this->ring[this->head] = this->intern(msg);
+        this->count++;
+        if (this->count == MESSAGE_MAX) {
+            this->release(this->ring[(this->head + this->count - 1) % MESSAGE_MAX]);
+            this->count--;
+        }
+    }
 
-    // 新たにメッセージを保持する msg_sp オブジェクトを生成し、検索用mapオブジェクトにも追加する
-    auto new_msg = msg_sp(new std::string(std::forward<T>(str)), std::move(deleter));
-    message_map.emplace(new_msg.get(), msg_wp(new_msg));
+    void pop_front()
+    {
+        this->release(this->ring[this->head]);
+        this->head = (this->head + 1) % MESSAGE_MAX;
+        this->count--;
+    }
 
-    return new_msg;
-}
+private:
+    static constexpr auto EMPTY_SLOT = -1;
+    static constexpr auto REMOVED_SLOT = -2;
+    static constexpr size_t MIN_TABLE_SIZE = 1024;
+    static constexpr size_t MIN_COMPACT_SIZE = 64 * 1024;
+
+    std::vector<int> ring{};
+    int head = 0;
+    int count = 0;
+    std::string arena{};
+    size_t dead_bytes = 0;
+    std::vector<interned_message> texts{};
+    std::vector<int> free_texts{};
+    int live_texts = 0;
+    std::vector<int> table{}; //!< 文字列の番号を持つ開番地法のハッシュ表
+    size_t used_slots = 0; //!< 削除済みを含む使用中のハッシュ表の要素数
+
+    std::string_view get_text(int id) const
+    {
+        const auto &text = this->texts[id];
+        return std::string_view(this->arena.data() + text.offset, text.length);
+    }
+
+    /*!
+     * @brief 文字列を登録し、その番号を返す
+     * @details 同じ文字列が登録済みならその参照を増やして共有する.
+     */
+    int intern(std::string_view msg)
+    {
+        if (this->table.empty()) {
+            this->rehash(MIN_TABLE_SIZE);
+        }
+
+        const auto hash = std::hash<std::string_view>()(msg);
+        const auto mask = this->table.size() - 1;
+        auto insert_pos = this->table.size();
+        auto pos = hash & mask;
+        for (; this->table[pos] != EMPTY_SLOT; pos = (pos + 1) & mask) {
+            const auto id = this->table[pos];
+            if (id == REMOVED_SLOT) {
+                insert_pos = std::min(insert_pos, pos);
+                continue;
+            }
+
+            if ((this->texts[id].hash == hash) && (this->get_text(id) == msg)) {
+                this->texts[id].refs++;
+                return id;
+            }
+        }
+
+        if (insert_pos == this->table.size()) {
+            insert_pos = pos;
+            this->used_slots++;
+        }
+
+        int id;
+        if (this->free_texts.empty()) {
+            id = static_cast<int>(this->texts.size());
+            this->texts.emplace_back();
+        } else {
+            id = this->free_texts.back();
+            this->free_texts.pop_back();
+        }
+
+        this->texts[id] = { static_cast<uint32_t>(this->arena.size()), static_cast<uint32_t>(msg.length()), 1, hash };
+        this->arena.append(msg);
+        this->arena.push_back('\0');
+        this->table[insert_pos] = id;
+        this->live_texts++;
+        if (this->used_slots * 2 > this->table.size()) {
+            this->rehash(std::max(MIN_TABLE_SIZE, std::bit_ceil(static_cast<size_t>(this->live_texts) * 4)));
+        }
+
+        return id;
+    }
+
+    void release(int id)
+    {
+        auto &text = this->texts[id];
+        if (--text.refs > 0) {
+            return;
+        }
+
+        const auto mask = this->table.size() - 1;
+        auto pos = text.hash & mask;
+        while (this->table[pos] != id) {
+            pos = (pos + 1) & mask;
+        }
+
+        this->table[pos] = REMOVED_SLOT;
+        this->dead_bytes += text.length + 1;
+        this->free_texts.push_back(id);
+        this->live_texts--;
+        if ((this->dead_bytes >= MIN_COMPACT_SIZE) && (this->dead_bytes * 2 > this->arena.size())) {
+            this->compact();
+        }
+    }
+
+    void rehash(size_t table_size)
+    {
+        this->table.assign(table_size, EMPTY_SLOT);
+        const auto mask = table_size - 1;
+        for (auto id = 0; id < static_cast<int>(this->texts.size()); id++) {
+            if (this->texts[id].refs == 0) {
+                continue;
+            }
+
+            auto pos = this->texts[id].hash & mask;
+            while (this->table[pos] != EMPTY_SLOT) {
+                pos = (pos + 1) & mask;
+            }
+
+            this->table[pos] = id;
+        }
+
+        this->used_slots = this->live_texts;
+    }
+
+    void compact()
+    {
+        std::string new_arena;
+        new_arena.reserve(this->arena.size() - this->dead_bytes);
+        for (auto &text : this->texts) {
+            if (text.refs == 0) {
+                continue;
+            }
+
+            const auto offset = new_arena.size();
+            new_arena.append(this->arena, text.offset, text.length + 1);
+            text.offset = static_cast<uint32_t>(offset);
+        }
+
+        this->arena = std::move(new_arena);
+        this->dead_bytes = 0;
+    }
+};
+
+/** メッセージ履歴 */
+message_log message_history;
 }
 
 /*!
@@ -78,31 +234,30 @@ int32_t message_num(void)
 /*!
  * @brief 過去のゲームメッセージを返す。 / Recall the "text" of a saved message
  * @param age メッセージの世代
- * @return メッセージの文字列ポインタ
+ * @return メッセージの文字列. 終端は'\0'で、次にメッセージを追加するまで有効
  */
-std::shared_ptr<const std::string> message_str(int age)
+std::string_view message_str(int age)
 {
     if ((age < 0) || (age >= message_num())) {
-        return std::make_shared<const std::string>("");
+        return "";
     }
 
-    return message_history[age];
+    return message_history.get(age);
 }
 
-static void message_add_aux(std::string str)
+static void message_add_aux(std::string_view msg)
 {
-    std::string splitted;
-
-    if (str.empty()) {
+    if (msg.empty()) {
         return;
     }
 
     // MAIN_TERM_MIN_COLS桁を超えるメッセージはMAIN_TERM_MIN_COLS桁ずつ分割する
-    if (str.length() > MAIN_TERM_MIN_COLS) {
+    std::string_view splitted;
+    if (msg.length() > MAIN_TERM_MIN_COLS) {
         int n;
 #ifdef JP
         for (n = 0; n < MAIN_TERM_MIN_COLS; n++) {
-            if (iskanji(str[n])) {
+            if (iskanji(msg[n])) {
                 n++;
             }
         }
@@ -113,7 +268,7 @@ static void message_add_aux(std::string str)
         }
 #else
         for (n = MAIN_TERM_MIN_COLS; n > MAIN_TERM_MIN_COLS - 20; n--) {
-            if (str[n] == ' ') {
+            if (msg[n] == ' ') {
                 break;
             }
         }
@@ -121,14 +276,15 @@ static void message_add_aux(std::string str)
             n = MAIN_TERM_MIN_COLS;
         }
 #endif
-        splitted = str.substr(n);
-        str = str.substr(0, n);
+        splitted = msg.substr(n);
+        msg = msg.substr(0, n);
     }
 
     // 直前と同じメッセージの場合、「～ <xNN>」と表示する
-    if (!message_history.empty()) {
+    std::string repeated;
+    if (message_history.size() > 0) {
         const char *t;
-        std::string_view last_message = *message_history.front();
+        std::string_view last_message = message_history.get(0);
 #ifdef JP
         for (t = last_message.data(); *t && (*t != '<' || (*(t + 1) != 'x')); t++) {
             if (iskanji(*t)) {
@@ -148,8 +304,9 @@ static void message_add_aux(std::string str)
             }
         }
 
-        if (str == last_message && (j < 1000)) {
-            str = format("%s <x%d>", str.data(), j + 1);
+        if (msg == last_message && (j < 1000)) {
+            repeated = format("%s <x%d>", std::string(msg).data(), j + 1);
+            msg = repeated;
             message_history.pop_front();
             if (!now_message) {
                 now_message++;
@@ -161,26 +318,11 @@ static void message_add_aux(std::string str)
         }
     }
 
-    msg_sp add_msg;
-
-    // メッセージ履歴から同一のメッセージを探す
-    if (const auto &it = message_map.find(&str); it != message_map.end()) {
-        // 同一のメッセージが見つかったならそのメッセージの msg_sp オブジェクトを複製
-        add_msg = it->second.lock();
-    } else {
-        // 見つからなかった場合は新たに msg_sp オブジェクトを作成
-        add_msg = make_message(std::move(str));
-    }
-
     // メッセージ履歴に追加
-    message_history.push_front(std::move(add_msg));
-
-    if (message_history.size() == MESSAGE_MAX) {
-        message_history.pop_back();
-    }
+    message_history.push_front(msg);
 
     if (!splitted.empty()) {
-        message_add_aux(std::move(splitted));
+        message_add_aux(splitted);
     }
 }
 
@@ -190,7 +332,7 @@ static void message_add_aux(std::string str)
  */
 void message_add(std::string_view msg)
 {
-    message_add_aux(std::string(msg));
+    message_add_aux(msg);
 }
 
 bool is_msg_window_flowed(void)
@@ -43,6 +43,7 @@
 #include "view/display-messages.h"
 #include "view/display-player.h"
 #include "view/object-describer.h"
+#include "window/found-item-list.h"
 #include "window/main-window-equipments.h"
 #include "window/main-window-util.h"
 #include "world/world.h"
@@ -51,7 +52,6 @@
 #include <mutex>
 #include <sstream>
 #include <string>
-#include <util/object-sort.h>
 
 /*! サブウィンドウ表示用の ItemTester オブジェクト */
 static std::unique_ptr<ItemTester> fix_item_tester = std::make_unique<AllMatchItemTester>();
@@ -410,7 +410,8 @@ void fix_message(void)
         [] {
             const auto &[wid, hgt] = term_get_size();
             for (short i = 0; i < hgt; i++) {
-                term_putstr(0, (hgt - 1) - i, -1, (byte)((i < now_message) ? TERM_WHITE : TERM_SLATE), *message_str(i));
+                // message_str() の文字列は次の message_add() まで有効. 描画中にメッセージは追加されない.
+                term_putstr(0, (hgt - 1) - i, -1, (byte)((i < now_message) ? TERM_WHITE : TERM_SLATE), message_str(i));
                 TERM_LEN x, y;
                 term_locate(&x, &y);
                 term_erase(x, y);
@@ -637,31 +638,12 @@ static void display_found_item_list(PlayerType *player_ptr)
         return;
     }
 
-    auto *floor_ptr = player_ptr->current_floor_ptr;
-
-    // 所持品一覧と同じ順にソートする
-    // あらかじめfloor_ptr->o_list から↓項目を取り除く
-    // bi_idが0
-    // OM_FOUNDフラグが立っていない
-    // ItemKindTypeがGOLD
-    std::vector<ItemEntity *> found_item_list;
-    for (auto &item : floor_ptr->o_list) {
-        const auto is_item_to_display =
-            item.is_valid() && (item.number > 0) &&
-            item.marked.has(OmType::FOUND) && (item.bi_key.tval() != ItemKindType::GOLD);
-
-        if (is_item_to_display) {
-            found_item_list.push_back(&item);
-        }
-    }
-
-    std::sort(
-        found_item_list.begin(), found_item_list.end(),
-        [player_ptr](ItemEntity *left, ItemEntity *right) -> bool {
-            return object_sort_comp(player_ptr, left, left->get_price(), right);
-        });
+    // 所持品一覧と同じ順に並べた一覧を、前回の並びに増減を反映して得る
+    const auto &found_item_list = FoundItemList::get_instance().update(player_ptr);
+    auto &o_list = player_ptr->current_floor_ptr->o_list;
 
-    term_clear();
+    // 全体を消去すると変化の無い行まで描き直しになるため、行ごとに上書きする
+    term_erase(0, 0);
     term_gotoxy(0, 0);
 
     // 先頭行を書く。
@@ -669,12 +651,15 @@ static void display_found_item_list(PlayerType *player_ptr)
 
     // 発見済みのアイテムを表示
     TERM_LEN term_y = 1;
-    for (auto item : found_item_list) {
+    for (const auto i : found_item_list) {
+        auto *item = &o_list[i];
+
         // 途中で行数が足りなくなったら終了。
         if (term_y >= hgt) {
             break;
         }
 
+        term_erase(0, term_y);
         term_gotoxy(0, term_y);
 
         // アイテムシンボル表示
@@ -693,6 +678,10 @@ static void display_found_item_list(PlayerType *player_ptr)
 
         ++term_y;
     }
+
+    for (; term_y < hgt; ++term_y) {
+        term_erase(0, term_y);
+    }
 }
 
 /*!
@@ -0,0 +1,96 @@
+/*!
+ * @brief 発見済みのアイテム一覧の並び順
+ * @details
+ * 一覧は所持品と同じ基準で並べるが、比較のたびにアイテムの価値を求めるため全体の並べ替えは重い.
+ * 通知の多くは1つのアイテムの出現・消滅・移動なので、前回の並びに差分を反映するだけで済ませる.
+ */
+
+#include "window/found-item-list.h"
+#include "object/tval-types.h"
+#include "system/floor-type-definition.h"
+#include "system/item-entity.h"
+#include "system/player-type-definition.h"
+#include "util/object-sort.h"
+#include <algorithm>
+
+FoundItemList FoundItemList::instance{};
+
+FoundItemList &FoundItemList::get_instance()
+{
+    return instance;
+}
+
+/*!
+ * @brief 発見済みのアイテム一覧に載せるアイテムかを判定する
+ * @details 数が0のもの、発見していないもの、金は載せない.
+ */
+bool FoundItemList::is_displayable(const ItemEntity &item)
+{
+    return item.is_valid() && (item.number > 0) && item.marked.has(OmType::FOUND) && (item.bi_key.tval() != ItemKindType::GOLD);
+}
+
+/*!
+ * @brief 発見済みのアイテム一覧の並び順を比較する
+ * @details 所持品と同じ順に並べ、順位の付かないアイテム同士は添字の順にして並びを一意に定める.
+ * @return left が先に並ぶならばTRUEを返す.
+ */
+bool FoundItemList::compare(PlayerType *player_ptr, OBJECT_IDX left, OBJECT_IDX right)
+{
+    auto &o_list = player_ptr->current_floor_ptr->o_list;
+    auto *left_ptr = &o_list[left];
+    auto *right_ptr = &o_list[right];
+    if (object_sort_comp(player_ptr, left_ptr, left_ptr->get_price(), right_ptr)) {
+        return true;
+    }
+
+    if (object_sort_comp(player_ptr, right_ptr, right_ptr->get_price(), left_ptr)) {
+        return false;
+    }
+
+    return left < right;
+}
+
+/*!
+ * @brief 現在のフロアに合わせて一覧を更新する
+ * @param player_ptr プレイヤーへの参照ポインタ
+ * @return 並べ終えたアイテムの添字の一覧
+ * @details
+ * 前回の一覧から載せなくなったアイテムを除き、新たに載せるアイテムだけを並べて差し込む.
+ * フロアを移った時は添字が別のアイテムを指すが、残った並びが崩れていれば全体を並べ直すため結果は変わらない.
+ */
+const std::vector<OBJECT_IDX> &FoundItemList::update(PlayerType *player_ptr)
+{
+    const auto &o_list = player_ptr->current_floor_ptr->o_list;
+    this->listed.assign(o_list.size(), false);
+    std::erase_if(this->indices, [this, &o_list](OBJECT_IDX i) {
+        if ((i >= std::ssize(o_list)) || !is_displayable(o_list[i])) {
+            return true;
+        }
+
+        this->listed[i] = true;
+        return false;
+    });
+
+    this->appeared.clear();
+    for (OBJECT_IDX i = 0; i < std::ssize(o_list); i++) {
+        if (!this->listed[i] && is_displayable(o_list[i])) {
+            this->appeared.push_back(i);
+        }
+    }
+
+    const auto comp = [player_ptr](OBJECT_IDX left, OBJECT_IDX right) {
+        return compare(player_ptr, left, right);
+    };
+
+    if (!std::is_sorted(this->indices.begin(), this->indices.end(), comp)) {
+        this->indices.insert(this->indices.end(), this->appeared.begin(), this->appeared.end());
+        std::sort(this->indices.begin(), this->indices.end(), comp);
+        return this->indices;
+    }
+
+    std::sort(this->appeared.begin(), this->appeared.end(), comp);
+    const auto middle = std::ssize(this->indices);
+    this->indices.insert(this->indices.end(), this->appeared.begin(), this->appeared.end());
+    std::inplace_merge(this->indices.begin(), this->indices.begin() + middle, this->indices.end(), comp);
+    return this->indices;
+}
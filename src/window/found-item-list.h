@@ -0,0 +1,38 @@
+#pragma once
+
+#include "system/angband.h"
+#include <vector>
+
+class ItemEntity;
+class PlayerType;
+
+/*!
+ * @brief 発見済みのアイテム一覧の並び順を保持する
+ * @details
+ * アイテムの出現・消滅・移動の通知 (SubWindowRedrawingFlag::FOUND_ITEMS) を受けて一覧を描き直す際に、
+ * 前回の並びを残したまま増減したアイテムだけを入れ替える.
+ * 残ったアイテムの順序が鑑定などで崩れていた時だけ全体を並べ直す.
+ */
+class FoundItemList {
+public:
+    FoundItemList(const FoundItemList &) = delete;
+    FoundItemList(FoundItemList &&) = delete;
+    FoundItemList &operator=(const FoundItemList &) = delete;
+    FoundItemList &operator=(FoundItemList &&) = delete;
+    ~FoundItemList() = default;
+
+    static FoundItemList &get_instance();
+    static bool is_displayable(const ItemEntity &item);
+    static bool compare(PlayerType *player_ptr, OBJECT_IDX left, OBJECT_IDX right);
+
+    const std::vector<OBJECT_IDX> &update(PlayerType *player_ptr);
+
+private:
+    FoundItemList() = default;
+
+    static FoundItemList instance;
+
+    std::vector<OBJECT_IDX> indices{};
+    std::vector<bool> listed{};
+    std::vector<OBJECT_IDX> appeared{};
+};
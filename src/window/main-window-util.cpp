@@ -1,4 +1,5 @@
 #include "window/main-window-util.h"
+#include "autopick/autopick-match-cache.h"
 #include "flavor/flavor-describer.h"
 #include "flavor/object-flavor-types.h"
 #include "floor/cave.h"
@@ -8,18 +9,22 @@
 #include "grid/grid.h"
 #include "monster-race/monster-race.h"
 #include "monster-race/race-indice-types.h"
+#include "perception/object-perception.h"
 #include "player/player-status.h"
 #include "system/floor-type-definition.h"
 #include "system/item-entity.h"
 #include "system/monster-race-info.h"
 #include "system/player-type-definition.h"
+#include "system/redrawing-flags-updater.h"
 #include "term/gameterm.h"
 #include "term/screen-processor.h"
 #include "term/term-color-types.h"
 #include "timed-effect/player-hallucination.h"
 #include "timed-effect/timed-effects.h"
+#include "util/point-2d.h"
 #include "view/display-map.h"
 #include "world/world.h"
+#include <algorithm>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -39,6 +44,59 @@ int match_autopick;
 ItemEntity *autopick_obj; /*!< 各種自動拾い処理時に使うオブジェクトポインタ */
 int feat_priority; /*!< マップ縮小表示時に表示すべき地形の優先度を保管する */
 
+namespace {
+/*!
+ * @brief 縮小マップの1マス分の表示
+ * @details 元のマップの1マスの評価結果と、縮小後の1区画の表示の両方に使う.
+ */
+struct overview_cell {
+    TERM_COLOR attr = TERM_WHITE;
+    char ch = ' ';
+    byte priority = 0;
+    byte shown_priority = 0; //!< 自動拾いの対象として選ばれたかを反映した優先度 (元のマップのマスのみ)
+    int match_autopick = -1;
+    ItemEntity *autopick_obj = nullptr;
+};
+
+/*!
+ * @brief 縮小マップの記録
+ * @details
+ * 縮小マップの表示にはフロアの全マスの map_info() が必要になるが、ほとんどのマスは前回の表示から変わらない.
+ * 元のマップの各マスの評価結果と縮小後の各区画を保持し、lite_spot() で通知されたマスだけを評価し直す.
+ * 自動拾いの判定結果も保持するため、自動拾いリストの世代が変わった時は全体を作り直す.
+ * アイテムの認識や鑑定は lite_spot() で通知されないため、アイテムの知識の世代が変わった時も全体を作り直す.
+ * どちらも外周に1マス分の枠を持たせ、隣のマスとの比較で範囲外を参照しないようにする.
+ */
+struct overview_map_cache {
+    const FloorType *floor_ptr = nullptr;
+    int floor_height = 0;
+    int floor_width = 0;
+    int height = 0; //!< 縮小マップの高さ (枠線抜)
+    int width = 0; //!< 縮小マップの幅 (枠線抜)
+    int yrat = 0;
+    int xrat = 0;
+    uint32_t autopick_epoch = 0;
+    uint32_t item_knowledge_generation = 0;
+    bool is_valid = false;
+    std::vector<overview_cell> grids{};
+    std::vector<overview_cell> blocks{};
+    std::vector<bool> is_dirty{};
+    std::vector<Pos2D> dirty_grids{};
+
+    overview_cell &get_grid(int y, int x)
+    {
+        return this->grids[y * (this->floor_width + 2) + x];
+    }
+
+    overview_cell &get_block(int y, int x)
+    {
+        return this->blocks[y * (this->width + 2) + x];
+    }
+};
+
+overview_map_cache overview_cache;
+}
+
 static const std::vector<std::pair<std::string_view, std::string_view>> simplify_list = {
 #ifdef JP
     { "の魔法書", "" }
@@ -68,9 +126,11 @@ void print_field(concptr info, TERM_LEN row, TERM_LEN col)
  * Note that, for efficiency, we contain an "optimized" version
  * of both "lite_spot()" and "print_rel()", and that we use the
  * "lite_spot()" function to display the player grid, if needed.
+ * マップ全体の再描画はマス単位の通知を伴わないため、縮小マップの記録も作り直させる.
  */
 void print_map(PlayerType *player_ptr)
 {
+    overview_cache.is_valid = false;
     auto [wid, hgt] = term_get_size();
     wid -= COL_MAP + 2;
     hgt -= ROW_MAP + 2;
@@ -158,120 +218,214 @@ static void display_shortened_item_name(PlayerType *player_ptr, ItemEntity *o_pt
 }
 
 /*!
- * @brief 縮小マップ表示 / Display a "small-scale" map of the dungeon in the active Term
+ * @brief 元のマップの1マスを縮小マップ用に評価し直す
  * @param player_ptr プレイヤー情報への参照ポインタ
- * @param cy 縮小マップ上のプレイヤーのy座標
- * @param cx 縮小マップ上のプレイヤーのx座標
- * @details
- * メインウィンドウ('M'コマンド)、サブウィンドウ兼(縮小図)用。
- * use_bigtile時に横の描画列数は1/2になる。
+ * @param y 元のマップ上のy座標
+ * @param x 元のマップ上のx座標
  */
-void display_map(PlayerType *player_ptr, int *cy, int *cx)
+static void evaluate_overview_grid(PlayerType *player_ptr, POSITION y, POSITION x)
 {
-    int i, j, x, y;
-
     TERM_COLOR ta;
     char tc;
+    match_autopick = -1;
+    autopick_obj = nullptr;
+    feat_priority = -1;
+    map_info(player_ptr, y, x, &ta, &tc, &ta, &tc);
+    auto &grid = overview_cache.get_grid(y + 1, x + 1);
+    grid.attr = ta;
+    grid.ch = tc;
+    grid.priority = static_cast<byte>(feat_priority);
+    grid.match_autopick = match_autopick;
+    grid.autopick_obj = autopick_obj;
+}
 
-    byte tp;
-
-    bool old_view_special_lite = view_special_lite;
-    bool old_view_granite_lite = view_granite_lite;
-
-    auto border_width = use_bigtile ? 2 : 1; //!< @note 枠線幅
-    auto [wid, hgt] = term_get_size();
-    hgt -= 2;
-    wid -= 12 + border_width * 2; //!< @note 描画桁数(枠線抜)
-    if (use_bigtile) {
-        wid = wid / 2 - 1;
-    }
-
-    auto *floor_ptr = player_ptr->current_floor_ptr;
-    const auto yrat = (floor_ptr->height + hgt - 1) / hgt;
-    const auto xrat = (floor_ptr->width + wid - 1) / wid;
-    view_special_lite = false;
-    view_granite_lite = false;
-
-    using std::vector;
-    vector<vector<TERM_COLOR>> ma(hgt + 2, vector<TERM_COLOR>(wid + 2, TERM_WHITE));
-    vector<vector<char>> mc(hgt + 2, vector<char>(wid + 2, ' '));
-    vector<vector<byte>> mp(hgt + 2, vector<byte>(wid + 2, 0));
-    vector<vector<int>> match_autopick_yx(hgt + 2, vector<int>(wid + 2, -1));
-    vector<vector<ItemEntity *>> object_autopick_yx(hgt + 2, vector<ItemEntity *>(wid + 2, nullptr));
-
-    vector<vector<TERM_COLOR>> bigma(floor_ptr->height + 2, vector<TERM_COLOR>(floor_ptr->width + 2, TERM_WHITE));
-    vector<vector<char>> bigmc(floor_ptr->height + 2, vector<char>(floor_ptr->width + 2, ' '));
-    vector<vector<byte>> bigmp(floor_ptr->height + 2, vector<byte>(floor_ptr->width + 2, 0));
-
-    for (i = 0; i < floor_ptr->width; ++i) {
-        for (j = 0; j < floor_ptr->height; ++j) {
-            x = i / xrat + 1;
-            y = j / yrat + 1;
-
-            match_autopick = -1;
-            autopick_obj = nullptr;
-            feat_priority = -1;
-            map_info(player_ptr, j, i, &ta, &tc, &ta, &tc);
-            tp = (byte)feat_priority;
-            if (match_autopick != -1 && (match_autopick_yx[y][x] == -1 || match_autopick_yx[y][x] > match_autopick)) {
-                match_autopick_yx[y][x] = match_autopick;
-                object_autopick_yx[y][x] = autopick_obj;
-                tp = 0x7f;
+/*!
+ * @brief 縮小マップの1区画を、含まれるマスの評価結果から作り直す
+ * @param y 縮小マップ上のy座標 (枠線を含む)
+ * @param x 縮小マップ上のx座標 (枠線を含む)
+ * @details
+ * 自動拾いの対象は列ごと、地形とモンスターの優先度は行ごとの順に調べる.
+ * 同じ優先度の候補がある時に先に見つけた方を採るため、全体を作り直した時と同じ順に走査する.
+ */
+static void build_overview_block(int y, int x)
+{
+    auto &cache = overview_cache;
+    auto &block = cache.get_block(y, x);
+    block = {};
+    const auto top = (y - 1) * cache.yrat;
+    const auto bottom = std::min(y * cache.yrat, cache.floor_height);
+    const auto left = (x - 1) * cache.xrat;
+    const auto right = std::min(x * cache.xrat, cache.floor_width);
+    for (auto i = left; i < right; i++) {
+        for (auto j = top; j < bottom; j++) {
+            auto &grid = cache.get_grid(j + 1, i + 1);
+            grid.shown_priority = grid.priority;
+            if ((grid.match_autopick != -1) && ((block.match_autopick == -1) || (block.match_autopick > grid.match_autopick))) {
+                block.match_autopick = grid.match_autopick;
+                block.autopick_obj = grid.autopick_obj;
+                grid.shown_priority = 0x7f;
             }
-
-            bigmc[j + 1][i + 1] = tc;
-            bigma[j + 1][i + 1] = ta;
-            bigmp[j + 1][i + 1] = tp;
         }
     }
 
-    for (j = 0; j < floor_ptr->height; ++j) {
-        for (i = 0; i < floor_ptr->width; ++i) {
-            x = i / xrat + 1;
-            y = j / yrat + 1;
-
-            tc = bigmc[j + 1][i + 1];
-            ta = bigma[j + 1][i + 1];
-            tp = bigmp[j + 1][i + 1];
-            if (mp[y][x] == tp) {
-                int t;
-                int cnt = 0;
-
-                for (t = 0; t < 8; t++) {
-                    if (tc == bigmc[j + 1 + ddy_cdd[t]][i + 1 + ddx_cdd[t]] && ta == bigma[j + 1 + ddy_cdd[t]][i + 1 + ddx_cdd[t]]) {
+    for (auto j = top; j < bottom; j++) {
+        for (auto i = left; i < right; i++) {
+            const auto &grid = cache.get_grid(j + 1, i + 1);
+            auto tp = grid.shown_priority;
+            if (block.priority == tp) {
+                auto cnt = 0;
+                for (auto t = 0; t < 8; t++) {
+                    const auto &neighbor = cache.get_grid(j + 1 + ddy_cdd[t], i + 1 + ddx_cdd[t]);
+                    if ((grid.ch == neighbor.ch) && (grid.attr == neighbor.attr)) {
                         cnt++;
                     }
                 }
+
                 if (cnt <= 4) {
                     tp++;
                 }
             }
 
-            if (mp[y][x] < tp) {
-                mc[y][x] = tc;
-                ma[y][x] = ta;
-                mp[y][x] = tp;
+            if (block.priority < tp) {
+                block.ch = grid.ch;
+                block.attr = grid.attr;
+                block.priority = tp;
+            }
+        }
+    }
+}
+
+/*!
+ * @brief 縮小マップの記録を全て作り直す
+ * @param player_ptr プレイヤー情報への参照ポインタ
+ * @param floor 表示するフロア
+ * @param hgt 縮小マップの高さ (枠線抜)
+ * @param wid 縮小マップの幅 (枠線抜)
+ * @param yrat 縮小マップの1区画の高さ
+ * @param xrat 縮小マップの1区画の幅
+ */
+static void rebuild_overview_map(PlayerType *player_ptr, const FloorType &floor, int hgt, int wid, int yrat, int xrat)
+{
+    auto &cache = overview_cache;
+    cache.floor_ptr = &floor;
+    cache.floor_height = floor.height;
+    cache.floor_width = floor.width;
+    cache.height = hgt;
+    cache.width = wid;
+    cache.yrat = yrat;
+    cache.xrat = xrat;
+    cache.autopick_epoch = AutopickMatchCache::get_instance().get_epoch();
+    cache.item_knowledge_generation = get_item_knowledge_generation();
+    cache.grids.assign((floor.height + 2) * (floor.width + 2), {});
+    cache.blocks.assign((hgt + 2) * (wid + 2), {});
+    cache.is_dirty.assign(floor.height * floor.width, false);
+    cache.dirty_grids.clear();
+    for (auto y = 0; y < floor.height; y++) {
+        for (auto x = 0; x < floor.width; x++) {
+            evaluate_overview_grid(player_ptr, y, x);
+        }
+    }
+
+    for (auto y = 1; y <= hgt; y++) {
+        for (auto x = 1; x <= wid; x++) {
+            build_overview_block(y, x);
+        }
+    }
+
+    const auto bottom = hgt + 1;
+    const auto right = wid + 1;
+    cache.get_block(0, 0).ch = cache.get_block(0, right).ch = cache.get_block(bottom, 0).ch = cache.get_block(bottom, right).ch = '+';
+    for (auto x = 1; x <= wid; x++) {
+        cache.get_block(0, x).ch = cache.get_block(bottom, x).ch = '-';
+    }
+
+    for (auto y = 1; y <= hgt; y++) {
+        cache.get_block(y, 0).ch = cache.get_block(y, right).ch = '|';
+    }
+
+    cache.is_valid = true;
+}
+
+/*!
+ * @brief 変化したマスを縮小マップの記録に反映する
+ * @param player_ptr プレイヤー情報への参照ポインタ
+ * @details 隣のマスとの一致も優先度の判定に使うため、変化したマスの周囲8マスを含む区画も作り直す.
+ */
+static void update_overview_map(PlayerType *player_ptr)
+{
+    auto &cache = overview_cache;
+    std::vector<int> blocks;
+    for (const auto &pos : cache.dirty_grids) {
+        cache.is_dirty[pos.y * cache.floor_width + pos.x] = false;
+        evaluate_overview_grid(player_ptr, pos.y, pos.x);
+        for (auto d = 0; d < 9; d++) {
+            const auto y = pos.y + ddy_ddd[d];
+            const auto x = pos.x + ddx_ddd[d];
+            if ((y < 0) || (x < 0) || (y >= cache.floor_height) || (x >= cache.floor_width)) {
+                continue;
             }
+
+            blocks.push_back((y / cache.yrat + 1) * (cache.width + 2) + (x / cache.xrat + 1));
         }
     }
 
-    x = wid + 1;
-    y = hgt + 1;
+    cache.dirty_grids.clear();
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+    for (const auto index : blocks) {
+        build_overview_block(index / (cache.width + 2), index % (cache.width + 2));
+    }
+}
 
-    mc[0][0] = mc[0][x] = mc[y][0] = mc[y][x] = '+';
-    for (x = 1; x <= wid; x++) {
-        mc[0][x] = mc[y][x] = '-';
+/*!
+ * @brief 縮小マップ表示 / Display a "small-scale" map of the dungeon in the active Term
+ * @param player_ptr プレイヤー情報への参照ポインタ
+ * @param cy 縮小マップ上のプレイヤーのy座標
+ * @param cx 縮小マップ上のプレイヤーのx座標
+ * @details
+ * メインウィンドウ('M'コマンド)、サブウィンドウ兼(縮小図)用。
+ * use_bigtile時に横の描画列数は1/2になる。
+ * 縮小した結果は記録しておき、次回は lite_spot() で通知されたマスとその周囲だけを評価し直す.
+ * マップ全体の再描画が要求された時、フロアや表示の大きさが変わった時、幻覚中は全て作り直す.
+ */
+void display_map(PlayerType *player_ptr, int *cy, int *cx)
+{
+    bool old_view_special_lite = view_special_lite;
+    bool old_view_granite_lite = view_granite_lite;
+
+    auto border_width = use_bigtile ? 2 : 1; //!< @note 枠線幅
+    auto [wid, hgt] = term_get_size();
+    hgt -= 2;
+    wid -= 12 + border_width * 2; //!< @note 描画桁数(枠線抜)
+    if (use_bigtile) {
+        wid = wid / 2 - 1;
     }
 
-    for (y = 1; y <= hgt; y++) {
-        mc[y][0] = mc[y][x] = '|';
+    const auto &floor = *player_ptr->current_floor_ptr;
+    const auto yrat = (floor.height + hgt - 1) / hgt;
+    const auto xrat = (floor.width + wid - 1) / wid;
+    view_special_lite = false;
+    view_granite_lite = false;
+
+    auto &cache = overview_cache;
+    auto is_rebuild_needed = !cache.is_valid || !w_ptr->character_dungeon;
+    is_rebuild_needed |= RedrawingFlagsUpdater::get_instance().has(MainWindowRedrawingFlag::MAP);
+    is_rebuild_needed |= player_ptr->effects()->hallucination()->is_hallucinated();
+    is_rebuild_needed |= cache.autopick_epoch != AutopickMatchCache::get_instance().get_epoch();
+    is_rebuild_needed |= cache.item_knowledge_generation != get_item_knowledge_generation();
+    is_rebuild_needed |= (cache.floor_ptr != &floor) || (cache.floor_height != floor.height) || (cache.floor_width != floor.width);
+    is_rebuild_needed |= (cache.height != hgt) || (cache.width != wid) || (cache.yrat != yrat) || (cache.xrat != xrat);
+    if (is_rebuild_needed) {
+        rebuild_overview_map(player_ptr, floor, hgt, wid, yrat, xrat);
+    } else {
+        update_overview_map(player_ptr);
     }
 
-    for (y = 0; y < hgt + 2; ++y) {
+    for (auto y = 0; y < hgt + 2; ++y) {
         term_gotoxy(COL_MAP, y);
-        for (x = 0; x < wid + 2; ++x) {
-            ta = ma[y][x];
-            tc = mc[y][x];
+        for (auto x = 0; x < wid + 2; ++x) {
+            const auto &block = cache.get_block(y, x);
+            auto ta = block.attr;
             if (!use_graphics) {
                 if (w_ptr->timewalk_m_idx) {
                     ta = TERM_DARK;
@@ -282,16 +436,17 @@ void display_map(PlayerType *player_ptr, int *cy, int *cx)
                 }
             }
 
-            term_add_bigch(ta, tc);
+            term_add_bigch(ta, block.ch);
         }
     }
 
-    for (y = 1; y < hgt + 1; ++y) {
+    for (auto y = 1; y < hgt + 1; ++y) {
         match_autopick = -1;
-        for (x = 1; x <= wid; x++) {
-            if (match_autopick_yx[y][x] != -1 && (match_autopick > match_autopick_yx[y][x] || match_autopick == -1)) {
-                match_autopick = match_autopick_yx[y][x];
-                autopick_obj = object_autopick_yx[y][x];
+        for (auto x = 1; x <= wid; x++) {
+            const auto &block = cache.get_block(y, x);
+            if (block.match_autopick != -1 && (match_autopick > block.match_autopick || match_autopick == -1)) {
+                match_autopick = block.match_autopick;
+                autopick_obj = block.autopick_obj;
             }
         }
 
@@ -312,6 +467,28 @@ void display_map(PlayerType *player_ptr, int *cy, int *cx)
     view_granite_lite = old_view_granite_lite;
 }
 
+/*!
+ * @brief マスの表示が変わったことを縮小マップに通知する
+ * @param y 変化したマスのy座標
+ * @param x 変化したマスのx座標
+ * @details 次に縮小マップを表示する時に、そのマスだけを評価し直す.
+ */
+void mark_overview_spot(POSITION y, POSITION x)
+{
+    auto &cache = overview_cache;
+    if (!cache.is_valid || (y < 0) || (x < 0) || (y >= cache.floor_height) || (x >= cache.floor_width)) {
+        return;
+    }
+
+    const auto index = y * cache.floor_width + x;
+    if (cache.is_dirty[index]) {
+        return;
+    }
+
+    cache.is_dirty[index] = true;
+    cache.dirty_grids.emplace_back(y, x);
+}
+
 void set_term_color(PlayerType *player_ptr, POSITION y, POSITION x, TERM_COLOR *ap, char *cp)
 {
     if (!player_ptr->is_located_at({ y, x })) {
@@ -20,5 +20,6 @@ class PlayerType;
 void print_field(concptr info, TERM_LEN row, TERM_LEN col);
 void print_map(PlayerType *player_ptr);
 void display_map(PlayerType *player_ptr, int *cy, int *cx);
+void mark_overview_spot(POSITION y, POSITION x);
 void set_term_color(PlayerType *player_ptr, POSITION y, POSITION x, TERM_COLOR *ap, char *cp);
 int panel_col_of(int col);
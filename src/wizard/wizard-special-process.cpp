@@ -45,6 +45,7 @@
 #include "monster/monster-describer.h"
 #include "monster/monster-description-types.h"
 #include "monster/monster-info.h"
+#include "monster/monster-spatial-index.h"
 #include "monster/monster-status.h"
 #include "monster/smart-learn-types.h"
 #include "mutation/mutation-investor-remover.h"
@@ -770,7 +771,10 @@ void set_gametime(void)
  */
 void wiz_zap_surrounding_monsters(PlayerType *player_ptr)
 {
-    for (MONSTER_IDX i = 1; i < player_ptr->current_floor_ptr->m_max; i++) {
+    const auto &floor = *player_ptr->current_floor_ptr;
+    const auto p_pos = player_ptr->get_position();
+    const auto m_idxs = MonsterSpatialIndex::get_instance().collect_in_rect(floor, { p_pos.y - MAX_PLAYER_SIGHT, p_pos.x - MAX_PLAYER_SIGHT }, { p_pos.y + MAX_PLAYER_SIGHT, p_pos.x + MAX_PLAYER_SIGHT });
+    for (const auto i : m_idxs) {
         auto *m_ptr = &player_ptr->current_floor_ptr->m_list[i];
         if (!m_ptr->is_valid() || (i == player_ptr->riding) || (m_ptr->cdis > MAX_PLAYER_SIGHT)) {
             continue;
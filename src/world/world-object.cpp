@@ -19,11 +19,21 @@
  * @param floo_ptr 現在フロアへの参照ポインタ
  * @return 開いているオブジェクト要素のID
  * @details
+ * 削除で空いた添字を最優先で再利用し、無ければ配列の末尾を伸ばす.
  * This routine should almost never fail, but in case it does,
  * we must be sure to handle "failure" of this routine.
  */
 OBJECT_IDX o_pop(FloorType *floor_ptr)
 {
+    while (!floor_ptr->o_free_list.empty()) {
+        const auto i = floor_ptr->o_free_list.back();
+        floor_ptr->o_free_list.pop_back();
+        if ((i < floor_ptr->o_max) && !floor_ptr->o_list[i].is_valid()) {
+            floor_ptr->o_cnt++;
+            return i;
+        }
+    }
+
     if (floor_ptr->o_max < w_ptr->max_o_idx) {
         OBJECT_IDX i = floor_ptr->o_max;
         floor_ptr->o_max++;